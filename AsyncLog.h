@@ -0,0 +1,317 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include "Options.h"
+#include "SharedState.h"
+
+using namespace std;
+
+/*NOTE: Console output that stays out of the periodic tasks. A task pushes a fixed-size binary record,
+    the format string and its arguments, into a lock-free ring and goes on; a background thread formats
+    the records and writes them to the console in batches. The ring takes records from any number of
+    threads and is read by the background thread only. When the ring is full the record is dropped and
+    counted, a task never waits for the console.
+
+    The format string and the text arguments are kept as pointers, so they must outlive the record:
+    string literals, or strings that never change once the subsystem has started. Every "{}" in the
+    format is replaced by the next argument. Errors and warnings go to cerr, the rest to cout. */
+
+enum LogLevel : uint8_t
+{
+    LOG_ERROR = 0,
+    LOG_WARNING = 1,
+    LOG_INFO = 2,
+    LOG_DEBUG = 3,
+};
+
+const size_t LOG_MAX_ARGUMENTS = 10;
+const size_t LOG_CAPACITY = 8192; // Number of records in the ring, a power of two.
+
+struct LogArgument
+{
+    enum Type : uint8_t
+    {
+        SIGNED,
+        UNSIGNED,
+        REAL,
+        TEXT,
+    } type;
+    union
+    {
+        int64_t signedValue;
+        uint64_t unsignedValue;
+        double realValue;
+        const char *textValue;
+    };
+};
+
+struct LogRecord
+{
+    const char *format;
+    uint8_t level;
+    uint8_t count; // Number of arguments.
+    LogArgument arguments[LOG_MAX_ARGUMENTS];
+};
+
+class AsyncLog
+{
+public:
+    AsyncLog() : cells(LOG_CAPACITY), enqueuePosition(0), dequeuePosition(0), verbosity(LOG_INFO), dropped(0), running(false)
+    {
+        for (size_t i = 0; i < LOG_CAPACITY; i++)
+        {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    // Starts the background thread. Records pushed before are kept and written once it runs.
+    void start(LogLevel level)
+    {
+        verbosity.store(level, memory_order_relaxed);
+        if (!running.exchange(true))
+        {
+            writer = thread(&AsyncLog::writeRecords, this);
+
+            // The subsystems exit from their termination threads, the records left are written first
+            static AsyncLog *started = this;
+            atexit([]
+                   { started->stop(); });
+        }
+    }
+
+    // Stops the background thread once every record in the ring is written.
+    void stop()
+    {
+        if (running.exchange(false))
+        {
+            writer.join();
+        }
+    }
+
+    bool enabled(LogLevel level) const
+    {
+        return level <= verbosity.load(memory_order_relaxed);
+    }
+
+    template <typename... Arguments>
+    void log(LogLevel level, const char *format, Arguments... arguments)
+    {
+        static_assert(sizeof...(Arguments) <= LOG_MAX_ARGUMENTS, "too many arguments for a log record");
+        if (!enabled(level))
+        {
+            return;
+        }
+
+        LogRecord record;
+        record.format = format;
+        record.level = level;
+        record.count = sizeof...(Arguments);
+        size_t i = 0;
+        (setArgument(record.arguments[i++], arguments), ...);
+        (void)i;
+
+        if (!push(record))
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Cell
+    {
+        atomic<size_t> sequence; // Position of the record the cell holds or waits for, see push() and pop().
+        LogRecord record;
+    };
+
+    static constexpr auto WRITE_PERIOD = chrono::milliseconds(5); // Wait of the background thread when the ring is empty
+
+    static void setArgument(LogArgument &argument, const char *value)
+    {
+        argument.type = LogArgument::TEXT;
+        argument.textValue = value;
+    }
+
+    static void setArgument(LogArgument &argument, double value)
+    {
+        argument.type = LogArgument::REAL;
+        argument.realValue = value;
+    }
+
+    static void setArgument(LogArgument &argument, float value)
+    {
+        setArgument(argument, double(value));
+    }
+
+    template <typename T>
+    static void setArgument(LogArgument &argument, T value)
+    {
+        static_assert(is_integral<T>::value || is_enum<T>::value, "log arguments are numbers or text");
+        if (is_signed<T>::value)
+        {
+            argument.type = LogArgument::SIGNED;
+            argument.signedValue = int64_t(value);
+        }
+        else
+        {
+            argument.type = LogArgument::UNSIGNED;
+            argument.unsignedValue = uint64_t(value);
+        }
+    }
+
+    // A cell is free for the record at "position" when its sequence equals the position, and holds that
+    // record once its sequence is position + 1. Producers claim positions with a compare-and-swap.
+    bool push(const LogRecord &record)
+    {
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & (LOG_CAPACITY - 1)];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                {
+                    cell.record = record;
+                    cell.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // Full, the cell still holds a record that was not written.
+            }
+            else
+            {
+                position = enqueuePosition.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Only called by the background thread.
+    bool pop(LogRecord &record)
+    {
+        Cell &cell = cells[dequeuePosition & (LOG_CAPACITY - 1)];
+        if (cell.sequence.load(memory_order_acquire) != dequeuePosition + 1)
+        {
+            return false;
+        }
+        record = cell.record;
+        cell.sequence.store(dequeuePosition + LOG_CAPACITY, memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+    static void format(const LogRecord &record, string &out)
+    {
+        size_t next = 0;
+        for (const char *p = record.format; *p; p++)
+        {
+            if (p[0] == '{' && p[1] == '}' && next < record.count)
+            {
+                const LogArgument &argument = record.arguments[next++];
+                switch (argument.type)
+                {
+                case LogArgument::SIGNED:
+                    out += to_string(argument.signedValue);
+                    break;
+                case LogArgument::UNSIGNED:
+                    out += to_string(argument.unsignedValue);
+                    break;
+                case LogArgument::REAL:
+                    appendReal(argument.realValue, out);
+                    break;
+                case LogArgument::TEXT:
+                    out += argument.textValue ? argument.textValue : "(null)";
+                    break;
+                }
+                p++;
+            }
+            else
+            {
+                out += *p;
+            }
+        }
+        out += '\n';
+    }
+
+    // Same text as "cout << value".
+    static void appendReal(double value, string &out)
+    {
+        char buffer[32];
+        int length = snprintf(buffer, sizeof(buffer), "%g", value);
+        out.append(buffer, length);
+    }
+
+    void writeRecords()
+    {
+        string standardOutput, errorOutput;
+        LogRecord record;
+        uint64_t reportedDrops = 0;
+
+        while (true)
+        {
+            bool stopping = !running.load(memory_order_acquire); // Read first, so the records pushed before stop() are written
+
+            standardOutput.clear();
+            errorOutput.clear();
+            while (pop(record))
+            {
+                format(record, record.level <= LOG_WARNING ? errorOutput : standardOutput);
+            }
+
+            uint64_t drops = dropped.load(memory_order_relaxed);
+            if (drops != reportedDrops)
+            {
+                errorOutput += to_string(drops - reportedDrops) + " log records dropped, the console could not keep up\n";
+                reportedDrops = drops;
+            }
+
+            if (!standardOutput.empty())
+            {
+                cout.write(standardOutput.data(), standardOutput.size());
+                cout.flush();
+            }
+            if (!errorOutput.empty())
+            {
+                cerr.write(errorOutput.data(), errorOutput.size());
+            }
+
+            if (stopping)
+            {
+                return;
+            }
+            if (standardOutput.empty() && errorOutput.empty())
+            {
+                this_thread::sleep_for(WRITE_PERIOD);
+            }
+        }
+    }
+
+    vector<Cell> cells;
+    alignas(64) atomic<size_t> enqueuePosition;
+    alignas(64) size_t dequeuePosition;
+    atomic<uint8_t> verbosity;
+    atomic<uint64_t> dropped; // Records lost because the ring was full
+    atomic<bool> running;
+    thread writer;
+};
+
+// Console output of the subsystem, started by its main().
+AsyncLog &asyncLog = makeGlobal<AsyncLog>();
+
+// Parses a "--verbosity" value, 0 for errors only up to 3 for debugging output. Throws a logic_error for any other value.
+inline LogLevel parseLogLevel(const string &value)
+{
+    return LogLevel(parseInteger(value, LOG_ERROR, LOG_DEBUG));
+}
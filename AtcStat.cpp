@@ -0,0 +1,183 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <limits>
+#include "Metrics.h"
+#include "Options.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: Prints the metrics published by the subsystems in "/atc_metrics", one line per interval, like
+    vmstat. Counters are printed as rates per second over the last interval, gauges as their current
+    value. The system does not have to be stopped or changed to be observed, this only maps the page
+    for reading.
+
+    Usage: AtcStat [--interval SECONDS] [--count N] [--list]
+        --interval is the time between two lines, 1 second by default.
+        --count is the number of lines printed, until interrupted by default.
+        --list prints what every column holds and exits. */
+
+const int HEADER_INTERVAL = 20; // Lines between two repetitions of the header
+
+// Width of the column of a metric.
+size_t columnWidth(const MetricDescription &metric)
+{
+    return max(strlen(metric.column), size_t(6));
+}
+
+// Prints the names of the subsystems over their columns, then the names of the columns.
+void printHeader()
+{
+    stringstream groups, columns;
+    for (size_t first = 0; first < METRIC_COUNT;)
+    {
+        // Metrics of the same subsystem are next to each other
+        size_t last = first;
+        size_t width = columnWidth(METRIC_DESCRIPTIONS[first]);
+        while (last + 1 < METRIC_COUNT && strcmp(METRIC_DESCRIPTIONS[last + 1].subsystem, METRIC_DESCRIPTIONS[first].subsystem) == 0)
+        {
+            last++;
+            width += 1 + columnWidth(METRIC_DESCRIPTIONS[last]);
+        }
+
+        string name = METRIC_DESCRIPTIONS[first].subsystem;
+        size_t dashes = (width > name.size()) ? width - name.size() : 0;
+        groups << (first > 0 ? " " : "") << string(dashes / 2, '-') << name << string(dashes - dashes / 2, '-');
+        for (size_t i = first; i <= last; i++)
+        {
+            columns << (i > 0 ? " " : "") << setw(columnWidth(METRIC_DESCRIPTIONS[i])) << METRIC_DESCRIPTIONS[i].column;
+        }
+        first = last + 1;
+    }
+    cout << groups.str() << endl
+         << columns.str() << endl;
+}
+
+// Reads every value of the page.
+void readValues(const MetricsPage *page, vector<uint64_t> &values)
+{
+    for (size_t i = 0; i < METRIC_COUNT; i++)
+    {
+        values[i] = page->values[i].value.load(memory_order_relaxed);
+    }
+}
+
+const char *ATCSTAT_USAGE = "Usage: AtcStat [--interval SECONDS] [--count N] [--list]";
+
+int main(int argc, char *argv[])
+{
+    double interval = 1;
+    long count = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (option == "--list")
+        {
+            for (const MetricDescription &metric : METRIC_DESCRIPTIONS)
+            {
+                cout << setw(8) << left << metric.subsystem << " " << setw(6) << metric.column << " "
+                     << (metric.kind == METRIC_COUNTER ? "per second" : "current   ") << "  " << metric.description << endl;
+            }
+            return 0;
+        }
+        if (i + 1 >= argc)
+        {
+            cerr << "Missing value for " << option << endl
+                 << ATCSTAT_USAGE << endl;
+            return 1;
+        }
+
+        try
+        {
+            if (option == "--interval")
+            {
+                interval = parseNumber(argv[++i], 0.01, 3600);
+            }
+            else if (option == "--count")
+            {
+                count = parseInteger(argv[++i], 0, numeric_limits<long>::max()); // 0 prints until interrupted
+            }
+            else
+            {
+                cerr << "Unknown option: " << option << endl
+                     << ATCSTAT_USAGE << endl;
+                return 1;
+            }
+        }
+        catch (const logic_error &)
+        {
+            cerr << "Invalid value for " << option << ": " << argv[i] << endl
+                 << ATCSTAT_USAGE << endl;
+            return 1;
+        }
+    }
+
+    // Attach to the page, without creating it
+    int fd = shm_open(METRICS_NAME, O_RDONLY, 0);
+    if (fd == -1)
+    {
+        perror("shm_open() for the metrics failed, is the system running?");
+        exit(1);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1 || size_t(status.st_size) < sizeof(MetricsPage))
+    {
+        cerr << "The metrics page is not complete, is the system starting?" << endl;
+        exit(1);
+    }
+
+    void *mapped = mmap(0, sizeof(MetricsPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        perror("mmap() for the metrics failed");
+        exit(1);
+    }
+
+    const MetricsPage *page = static_cast<const MetricsPage *>(mapped);
+    if (!isMetricsPage(page))
+    {
+        cerr << "The metrics page was created by another version of the system." << endl;
+        exit(1);
+    }
+
+    vector<uint64_t> previous(METRIC_COUNT), current(METRIC_COUNT);
+    readValues(page, previous);
+    steady_clock::time_point previousTime = steady_clock::now();
+
+    for (long line = 0; count == 0 || line < count; line++)
+    {
+        this_thread::sleep_for(duration<double>(interval));
+        readValues(page, current);
+        steady_clock::time_point now = steady_clock::now();
+        double elapsed = duration<double>(now - previousTime).count();
+
+        if (line % HEADER_INTERVAL == 0)
+        {
+            printHeader();
+        }
+
+        stringstream values;
+        for (size_t i = 0; i < METRIC_COUNT; i++)
+        {
+            const MetricDescription &metric = METRIC_DESCRIPTIONS[i];
+            double value = (metric.kind == METRIC_COUNTER) ? (current[i] - previous[i]) / elapsed : current[i];
+            value /= metric.scale;
+            values << (i > 0 ? " " : "") << setw(columnWidth(metric)) << fixed << setprecision(value < 100 ? 1 : 0) << value;
+        }
+        cout << values.str() << endl;
+
+        previous.swap(current);
+        previousTime = now;
+    }
+
+    munmap(mapped, sizeof(MetricsPage));
+    return 0;
+}
@@ -14,6 +14,8 @@ const char *SHARED_MEMORY_AUGMENTED_DATA = "/AugmentedData";
 const char *SHARED_MEMORY_ALERTS = "/AlertsData";
 const char *SHARED_MEMORY_COMMUNICATIONS = "/shm_communication";
 const char *SHARED_MEMORY_RADAR = "/radar_shm";
+const char *SHARED_MEMORY_CLOCK = "/atc_clock";
+const char *SHARED_MEMORY_METRICS = "/atc_metrics";
 
 // Names of all the semaphores used in the system.
 const char *SEMAPHORE_LOGS = "/logs_semaphore";
@@ -25,6 +27,9 @@ const char *SEMAPHORE_RADAR = "/radar_semaphore";
 const char *ALERTS_SEMAPHORE_NAME = "/alerts_semaphore";
 const char *COMMUNICATION_SEMAPHORE_NAME = "/communication_semaphore";
 const char *DATADISPLAY_SEMAPHORE_NAME = "/datadisplay_semaphore";
+const char *OPERATOR_DOORBELL = "/operator_doorbell";
+const char *COMMUNICATION_DOORBELL = "/communication_doorbell";
+const char *RADAR_DOORBELL = "/radar_doorbell";
 
 int main()
 {
@@ -64,6 +69,16 @@ int main()
         perror("Error unlinking SHARED_MEMORY_RADAR");
     }
 
+    if (shm_unlink(SHARED_MEMORY_CLOCK) == -1)
+    {
+        perror("Error unlinking SHARED_MEMORY_CLOCK");
+    }
+
+    if (shm_unlink(SHARED_MEMORY_METRICS) == -1)
+    {
+        perror("Error unlinking SHARED_MEMORY_METRICS");
+    }
+
     // Unlink semaphores
     if (sem_unlink(SEMAPHORE_LOGS) == -1)
     {
@@ -110,5 +125,20 @@ int main()
         perror("Error unlinking DATADISPLAY_SEMAPHORE_NAME");
     }
 
+    if (sem_unlink(OPERATOR_DOORBELL) == -1)
+    {
+        perror("Error unlinking OPERATOR_DOORBELL");
+    }
+
+    if (sem_unlink(COMMUNICATION_DOORBELL) == -1)
+    {
+        perror("Error unlinking COMMUNICATION_DOORBELL");
+    }
+
+    if (sem_unlink(RADAR_DOORBELL) == -1)
+    {
+        perror("Error unlinking RADAR_DOORBELL");
+    }
+
     cout << "All shared memory and semaphores have been unlinked." << endl;
 }
\ No newline at end of file
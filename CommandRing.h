@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "SharedState.h"
+
+using namespace std;
+
+/*NOTE: Layout of the operator commands ("/shm_logs"), written by the Operator and read by the Computer.
+    The commands are a single-producer, single-consumer ring of fixed-size records. The Operator writes a
+    record at "head" and then moves head forward, the Computer reads the records from "tail" to head and
+    then moves tail forward, so neither side ever waits for the other or takes a lock. Every record holds
+    its sequence number, the value of head when it was written, so a record that does not belong at its
+    position is never taken for a command. The Operator reports a full ring instead of overwriting a
+    command the Computer has not read. */
+
+const uint32_t COMMAND_RING_MAGIC = 0x444D4D43; // "CMMD"
+const uint32_t COMMAND_RING_VERSION = 1;
+const uint32_t COMMAND_RING_CAPACITY = 256; // Number of records, a power of two.
+
+enum OperatorCommandKind : int32_t
+{
+    COMMAND_SPEED_CHANGE = 1,
+    COMMAND_AUGMENTED_INFORMATION = 2,
+};
+
+struct OperatorCommand
+{
+    uint64_t sequence; // Position of the command in the stream of commands, starting at 0.
+    uint64_t issuedAt; // CLOCK_MONOTONIC nanoseconds at which the Operator issued the command.
+    int32_t kind;      // One of OperatorCommandKind.
+    int32_t aircraftID;
+    int32_t speedX, speedY, speedZ; // New speed, for a speed change.
+    int32_t reserved;
+};
+
+struct CommandRingHeader
+{
+    atomic<uint32_t> magic; // Stored last, once the rest of the header is written.
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t reserved;
+    alignas(64) atomic<uint64_t> head; // Sequence of the next command written, only moved by the Operator.
+    alignas(64) atomic<uint64_t> tail; // Sequence of the next command read, only moved by the Computer.
+};
+
+const size_t COMMAND_RING_SIZE = sizeof(CommandRingHeader) + COMMAND_RING_CAPACITY * sizeof(OperatorCommand);
+
+class CommandRing
+{
+public:
+    // The segment must be mapped with at least COMMAND_RING_SIZE bytes.
+    CommandRing(void *segment) : header(static_cast<CommandRingHeader *>(segment)),
+                                 records(reinterpret_cast<OperatorCommand *>(static_cast<char *>(segment) + sizeof(CommandRingHeader))) {}
+
+    // Called by the Operator when it creates the ring, before any command is written.
+    void initialize()
+    {
+        header->magic.store(0, memory_order_relaxed);
+        header->version = COMMAND_RING_VERSION;
+        header->capacity = COMMAND_RING_CAPACITY;
+        header->head.store(0, memory_order_relaxed);
+        header->tail.store(0, memory_order_relaxed);
+        header->magic.store(COMMAND_RING_MAGIC, memory_order_release);
+    }
+
+    bool isReady() const
+    {
+        return header->magic.load(memory_order_acquire) == COMMAND_RING_MAGIC && header->version == COMMAND_RING_VERSION && header->capacity == COMMAND_RING_CAPACITY;
+    }
+
+    // Called by the Operator. Returns false, without writing the command, if the ring is full.
+    bool push(OperatorCommand command)
+    {
+        uint64_t head = header->head.load(memory_order_relaxed);
+        if (head - header->tail.load(memory_order_acquire) >= COMMAND_RING_CAPACITY)
+        {
+            return false;
+        }
+
+        command.sequence = head;
+        records[head % COMMAND_RING_CAPACITY] = command;
+        header->head.store(head + 1, memory_order_release);
+        return true;
+    }
+
+    // Called by the Computer. Appends every pending command to "commands" and returns the number of
+    // records skipped because their sequence did not match their position.
+    size_t drain(vector<OperatorCommand> &commands)
+    {
+        if (!isReady())
+        {
+            return 0;
+        }
+
+        size_t skipped = 0;
+        uint64_t tail = header->tail.load(memory_order_relaxed);
+        uint64_t head = header->head.load(memory_order_acquire);
+        for (; tail != head; tail++)
+        {
+            const OperatorCommand &command = records[tail % COMMAND_RING_CAPACITY];
+            if (command.sequence == tail)
+            {
+                commands.push_back(command);
+            }
+            else
+            {
+                skipped++;
+            }
+        }
+        header->tail.store(tail, memory_order_release);
+        return skipped;
+    }
+
+private:
+    CommandRingHeader *header;
+    OperatorCommand *records;
+};
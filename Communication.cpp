@@ -7,10 +7,16 @@
 #include <semaphore.h>
 #include <cstring>
 #include <sstream>
+#include <unordered_map>
+#include "RadarData.h"
+#include "Doorbell.h"
+#include "TaskMetrics.h"
+#include "Metrics.h"
 
 using namespace std;
 
 const char *shared_comms = "/shm_communication";
+const char *shared_radar = "/radar_shm";
 const char *sem_comms = "/comm_semaphore";
 
 int shm_fd_term;
@@ -21,23 +27,43 @@ const char *shm_termination = "/shm_term";
 const char *sem_termination = "/term_semaphore";
 const int size3 = 64;
 
-const int max_planes = 10;
+uint32_t max_planes; // capacity of the radar, read from its shared memory
+int shm_fd_radar;
+void *radarSegment; // radar shared memory, its registry tells which aircrafts are in the airspace
+size_t radarSize;
 
-struct SharedAircraft
-{
-    int aircraftID;
-    double positionX, positionY, positionZ;
-    double speedX, speedY, speedZ;
-    int startTime;
-};
-
-const int size = sizeof(SharedAircraft) * max_planes;
-const int size2 = 256;
+const int size2 = COMMAND_AREA_SIZE;
 
 sem_t *sem_comm;
 int shm_fd_comm;
 void *shm_ptr_comm_2;
-SharedAircraft *shm_ptr_comm;
+SpeedChangeHeader *shm_ptr_comm_header;
+SpeedChange *shm_ptr_comm;
+unordered_map<int, uint32_t> pendingPosition; // position of the last request of every aircraft in the speed change list
+
+Doorbell *commandDoorbell; // rung by the computer once it has written a command
+Doorbell *radarDoorbell;   // rung once the speed change list has a new request for the radar
+HopLatency &computerHop = taskMetrics.addHop("Computer -> Communication");
+TaskMetrics &commandMetrics = taskMetrics.add("communication command");
+
+void openRadarSegment()
+{ // the speed change list holds one entry per aircraft the radar can track
+    shm_fd_radar = shm_open(shared_radar, O_RDONLY, 0777);
+    if (shm_fd_radar == -1)
+    {
+        perror("radar shared memory failed");
+        exit(EXIT_FAILURE);
+    }
+
+    radarSegment = mapRadarSegment(shm_fd_radar, PROT_READ, radarSize);
+    if (radarSegment == MAP_FAILED)
+    {
+        perror("Error with radar shared memory mapping");
+        exit(EXIT_FAILURE);
+    }
+
+    max_planes = static_cast<RadarHeader *>(radarSegment)->capacity;
+}
 
 void startCommSharedMemory()
 { // open shared memory to radar
@@ -48,20 +74,21 @@ void startCommSharedMemory()
         exit(EXIT_FAILURE);
     }
 
-    if (ftruncate(shm_fd_comm, size2 + size) == -1)
+    if (ensureSegmentSize(shm_fd_comm, communicationSegmentSize(max_planes)) == -1)
     {
         perror("error with size of shared memory");
         exit(EXIT_FAILURE);
     }
 
-    shm_ptr_comm_2 = mmap(0, size2 + size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_comm, 0);
+    shm_ptr_comm_2 = mmap(0, communicationSegmentSize(max_planes), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_comm, 0);
     if (shm_ptr_comm_2 == MAP_FAILED)
     {
         perror("Error with shared memory mapping");
         exit(EXIT_FAILURE);
     }
 
-    shm_ptr_comm = (SharedAircraft *)((char *)shm_ptr_comm_2 + size2);
+    shm_ptr_comm_header = speedChangeHeader(shm_ptr_comm_2);
+    shm_ptr_comm = speedChanges(shm_ptr_comm_2);
     sem_comm = sem_open(sem_comms, O_CREAT, 0777, 1);
     if (sem_comm == SEM_FAILED)
     {
@@ -69,6 +96,10 @@ void startCommSharedMemory()
         exit(EXIT_FAILURE);
     }
 
+    sem_wait(sem_comm);
+    shm_ptr_comm_header->capacity = max_planes;
+    sem_post(sem_comm);
+
     cout << "Communication shared memory and semaphore successful" << endl;
 }
 
@@ -83,31 +114,64 @@ void CommunicationCommand()
     string command(commandBuffer);
     if (command.empty())
         return;
+    ScopedTaskTimer timer(commandMetrics); // only the wake-ups that read a command are timed
 
     istringstream iss(command);
 
     int newSpeedX, newSpeedY, newSpeedZ, aircraftID;
-    iss >> aircraftID >> newSpeedX >> newSpeedY >> newSpeedZ;
+    uint64_t issuedAt = 0, sentAt = 0; // stamped by the operator and by the computer
+    iss >> aircraftID >> newSpeedX >> newSpeedY >> newSpeedZ >> issuedAt >> sentAt;
+    computerHop.record(sentAt);
 
     cout << "Speed Change request for aircraft ID recieved: " << aircraftID << endl;
 
+    SharedAircraft aircraft;
+    if (!readRadarAircraft(radarSegment, aircraftID, aircraft))
+    { // the radar would have nothing to apply the request to
+        cerr << "Aircraft " << aircraftID << " is not in the airspace, request dropped" << endl;
+        systemMetrics.add(COMMUNICATION_DROPPED);
+        sem_wait(sem_comm);
+        memset(shm_ptr_comm_2, 0, size2);
+        sem_post(sem_comm);
+        return;
+    }
+
     sem_wait(sem_comm);
 
-    for (int i = 0; i < max_planes; ++i)
+    // the pending request of the aircraft is replaced, otherwise a new request is added to the list
+    uint32_t pending = min(shm_ptr_comm_header->count, max_planes);
+    if (pending == 0)
+        pendingPosition.clear(); // the radar has applied the list, every position is stale
+    auto known = pendingPosition.find(aircraftID);
+    uint32_t i = (known != pendingPosition.end() && known->second < pending && shm_ptr_comm[known->second].aircraftID == aircraftID)
+                     ? known->second
+                     : pending;
+
+    if (i < max_planes)
     { // send selected aircraft
-        if (shm_ptr_comm[i].aircraftID == aircraftID)
-        {
-            shm_ptr_comm[i].aircraftID = aircraftID;
-            shm_ptr_comm[i].speedX = newSpeedX;
-            shm_ptr_comm[i].speedY = newSpeedY;
-            shm_ptr_comm[i].speedZ = newSpeedZ;
-            cout << "Speed updated: (" << newSpeedX << ", " << newSpeedY << ", " << newSpeedZ << ")" << endl;
-            break;
-        }
+        shm_ptr_comm[i].aircraftID = aircraftID;
+        shm_ptr_comm[i].speedX = newSpeedX;
+        shm_ptr_comm[i].speedY = newSpeedY;
+        shm_ptr_comm[i].speedZ = newSpeedZ;
+        shm_ptr_comm[i].issuedAt = issuedAt;
+        shm_ptr_comm[i].forwardedAt = monotonicNanoseconds();
+        if (i == pending)
+            shm_ptr_comm_header->count = pending + 1;
+        pendingPosition[aircraftID] = i;
+        cout << "Speed updated: (" << newSpeedX << ", " << newSpeedY << ", " << newSpeedZ << ")" << endl;
+        systemMetrics.add(COMMUNICATION_COMMANDS);
+    }
+    else
+    {
+        cerr << "Speed change list full, request for aircraft " << aircraftID << " dropped" << endl;
+        systemMetrics.add(COMMUNICATION_DROPPED);
     }
 
     memset(shm_ptr_comm_2, 0, size2);
     sem_post(sem_comm);
+
+    if (i < max_planes)
+        radarDoorbell->ring();
 }
 
 bool checkTermination()
@@ -128,6 +192,7 @@ void monitorTermination()
         if (checkTermination())
         {
             cout << "Termination signal received. Terminating communications subsystem." << endl;
+            taskMetrics.print(cout); // timing of every task and hop over the whole run
             sem_wait(sem_term);
             strncpy((char *)shm_ptr_term, "Communications", size3 - 1);
             ((char *)shm_ptr_term)[size3 - 1] = '\0';
@@ -137,7 +202,10 @@ void monitorTermination()
             close(shm_fd_term);
             sem_close(sem_term);
 
-            munmap(shm_ptr_comm_2, size2 + size);
+            munmap(radarSegment, radarSize);
+            close(shm_fd_radar);
+
+            munmap(shm_ptr_comm_2, communicationSegmentSize(max_planes));
             close(shm_fd_comm);
             sem_close(sem_comm);
 
@@ -182,15 +250,21 @@ void startTerminationMonitor()
 
 int main()
 {
+    installTaskMetricsSignal(); // "kill -USR1" prints the timing of the commands, before any thread is started
+    systemMetrics.open();
+    openRadarSegment();
     startCommSharedMemory();
     startTerminationMonitor();
 
+    commandDoorbell = new Doorbell(COMMUNICATION_DOORBELL);
+    radarDoorbell = new Doorbell(RADAR_DOORBELL);
+
     thread monitor(monitorTermination);
 
     while (true)
-    {
+    { // the command is handled as soon as the computer rings, the list is still checked every second without one
+        commandDoorbell->wait(1.0);
         CommunicationCommand();
-        sleep(1);
     }
     monitor.join();
 
@@ -1,8 +1,72 @@
 #include "Computer.h";
+#include "Options.h"
 
-int main()
+const char *COMPUTER_USAGE = "Usage: Computer [--workers N] [--tracks N] [--verbosity N] [--task-workers N] [--realtime-priority N]";
+
+int main(int argc, char *argv[])
 {
-    Computer computer;
+    // The number of conflict workers can be set with "--workers N", it defaults to one per core.
+    // The number of aircrafts sent to the Visual Display can be set with "--tracks N".
+    // The console output can be set with "--verbosity N", from 0 for errors only to 3 for debugging.
+    // The periodic tasks run on "--task-workers N" threads, under SCHED_FIFO from "--realtime-priority N" if given.
+    // "kill -USR1" prints the timing of every task, the signal is set up before any thread is started.
+    installTaskMetricsSignal();
+
+    size_t conflictWorkers = thread::hardware_concurrency();
+    uint32_t trackCapacity = DEFAULT_TRACK_CAPACITY;
+    LogLevel verbosity = LOG_INFO;
+    size_t taskWorkers = DEFAULT_TASK_WORKERS;
+    int realtimePriority = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            cerr << "Missing value for " << option << endl
+                 << COMPUTER_USAGE << endl;
+            return 1;
+        }
+
+        try
+        {
+            if (option == "--workers")
+            {
+                conflictWorkers = parseInteger(argv[++i], 0, 1024);
+            }
+            else if (option == "--tracks")
+            {
+                trackCapacity = parseInteger(argv[++i], 1, 1 << 20);
+            }
+            else if (option == "--verbosity")
+            {
+                verbosity = parseLogLevel(argv[++i]);
+            }
+            else if (option == "--task-workers")
+            {
+                taskWorkers = parseInteger(argv[++i], 1, 64);
+            }
+            else if (option == "--realtime-priority")
+            {
+                realtimePriority = parseInteger(argv[++i], 0, 99);
+            }
+            else
+            {
+                cerr << "Unknown option: " << option << endl
+                     << COMPUTER_USAGE << endl;
+                return 1;
+            }
+        }
+        catch (const logic_error &)
+        {
+            cerr << "Invalid value for " << option << ": " << argv[i] << endl
+                 << COMPUTER_USAGE << endl;
+            return 1;
+        }
+    }
+    asyncLog.start(verbosity);
+    systemMetrics.open();
+
+    Computer computer(conflictWorkers, trackCapacity, taskWorkers, realtimePriority);
     computer.run();
     return 0;
 }
\ No newline at end of file
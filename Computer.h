@@ -16,18 +16,33 @@
 #include <unistd.h>    // For ftruncate
 #include <cstring>     // For memcpy
 #include "Aircraft.h"
+#include "SpatialGrid.h"
+#include "SweepAndPrune.h"
+#include "ConflictKernel.h"
+#include "WorkStealingPool.h"
+#include "PredictionCache.h"
+#include "ConflictCalendar.h"
+#include "SimClock.h"
+#include "DisplayData.h"
+#include "RadarData.h"
+#include "Doorbell.h"
+#include "CommandRing.h"
+#include "AsyncLog.h"
+#include "TrackStore.h"
+#include "PeriodicExecutor.h"
+#include "TaskMetrics.h"
+#include "Metrics.h"
 #include <sstream>
+#include <unordered_set>
 
 // m1
 #define shared_name "/radar_shm"
-#define sem_name "/radar_semaphore"
 
 using namespace std;
 using namespace std::chrono;
 
 // m2
 mutex air_mutex;
-sem_t *sem_plane;
 
 // Semaphore names
 const char *AIRCRAFT_SEMAPHORE_NAME = "/aircraft_semaphore";
@@ -54,6 +69,25 @@ const char *SHARED_MEMORY_COMMUNICATION = "/shm_communication";
 const char *SEMAPHORE_COMMUNICATION = "/comm_semaphore";
 
 const int COMM_SHM_SIZE = 4096; // Shared memory size for communication
+const int COMMUNICATION_WAIT_ATTEMPTS = 10000; // Polls of 100 us, a second at most, for the Communication subsystem to read the last command
+
+// Separation minima, also used as the cell size of the spatial grid
+const double HORIZONTAL_SEPARATION = 3000.0;
+const double VERTICAL_SEPARATION = 1000.0;
+const double COLLISION_LOOKAHEAD = 120.0; // How far ahead future collisions are predicted, in seconds
+
+// Times to conflict, in seconds, at which a predicted collision raises an alert
+const vector<double> WARNING_THRESHOLDS = {120, 60, 30, 10, 0};
+
+const size_t CONFLICT_TILE_PAIRS = 4096; // Approximate number of candidate pairs handled by one tile of the conflict pool
+
+const uint32_t DEFAULT_TRACK_CAPACITY = 1024; // Default number of aircrafts the Visual Display can be sent
+const double RADAR_UPDATE_PERIOD = 1;         // Seconds between two updates of the tracks from the radar
+const uint64_t KEYFRAME_INTERVAL = 10;        // Publications of the tracks between two keyframes for the Visual Display
+const double VIOLATION_CHECK_PERIOD = 3;      // Seconds between two scans for violations and conflicts
+const double TERMINATION_CHECK_PERIOD = 10;   // Seconds of real time between two checks of the termination signal
+const double HISTORY_LOG_PERIOD = 20;         // Seconds between two writes of the tracks to the history file
+const size_t DEFAULT_TASK_WORKERS = 2;        // Threads running the periodic tasks, unless configured otherwise
 
 sem_t *sem_logs;    // Semaphore for operator commands
 sem_t *sem_term;    // Semaphore for termination signal
@@ -66,56 +100,39 @@ sem_t *sem_comm;    // Semaphore for communication
 void *shm_ptr_comm; // Pointer to shared memory for communication
 int shm_fd_comm;    // File descriptor for shared memory (communication)
 
-void *shm_ptr_alerts;    // Pointer to shared memory for alerts
-void *shm_ptr_aircrafts; // Pointer to shared memory for aircraft data
-int shm_fd_alerts;       // File descriptor for shared memory (alerts)
-int shm_fd_aircrafts;    // File descriptor for shared memory (aircraft data)
-mutex alertsMutex;       // Mutex for protecting alerts shared memory
-mutex aircraftsMutex;    // Mutex for protecting aircraft data shared memory
+void *shm_ptr_alerts;  // Pointer to shared memory for alerts
+int shm_fd_alerts;     // File descriptor for shared memory (alerts)
+mutex alertsMutex;     // Mutex for protecting alerts shared memory
+mutex aircraftsMutex;  // Mutex for protecting aircraft data shared memory
 
 sem_t *sem_augmentedInfo;    // Semaphore for augmented information
 void *shm_ptr_augmentedInfo; // Pointer to shared memory for augmented information
 int shm_fd_augmentedInfo;    // File descriptor for shared memory (augmented information)
 
-struct SharedAircraft
-{
-    int aircraftID;
-    double positionX, positionY, positionZ;
-    double speedX, speedY, speedZ;
-    int startTime;
-};
-
 int shm_fdd;
-SharedAircraft *sharedAircraftList;
-
-// Struct for the Alerts to store in a priority queue
-struct Alert
-{
-    double time;
-    string message;
-
-    bool operator<(const Alert &other) const
-    {
-        return time > other.time; // Higher priority for more imminent alerts
-    }
-};
+void *radarSegment; // Radar shared memory, read through its sequence lock
 
 class Computer
 {
 public:
-    // Constructor
-    Computer() : terminate(false), logFile("history.txt", ios::out | ios::app)
+    // Constructor, conflictWorkers is the number of threads used for the pairwise conflict checks,
+    // trackCapacity the number of aircrafts the shared memory for the Visual Display can hold, taskWorkers the
+    // number of threads running the periodic tasks and realtimePriority their SCHED_FIFO priority, 0 for none
+    Computer(size_t conflictWorkers, uint32_t trackCapacity, size_t taskWorkers = DEFAULT_TASK_WORKERS, int realtimePriority = 0)
+        : terminate(false), executor(simClock, taskWorkers, realtimePriority), trackCapacity(trackCapacity), logFile("history.txt", ios::out | ios::app), violationGrid(HORIZONTAL_SEPARATION, HORIZONTAL_SEPARATION, VERTICAL_SEPARATION),
+                                       collisionSweep(COLLISION_LOOKAHEAD, HORIZONTAL_SEPARATION / 2, VERTICAL_SEPARATION / 2),
+                                       conflictPool(conflictWorkers), calendar(simClock, WARNING_THRESHOLDS)
     {
         if (!logFile.is_open())
         {
-            cerr << "Error opening log file." << endl;
+            asyncLog.log(LOG_ERROR, "Error opening log file.");
         }
         else
         {
             logFile << "Computer object created." << endl;
         }
 
-        cout << "Computer object created." << endl;
+        asyncLog.log(LOG_INFO, "Computer object created.");
 
         sem_unlink(AIRCRAFT_SEMAPHORE_NAME);
         sem_unlink(ALERTS_SEMAPHORE_NAME);
@@ -163,7 +180,7 @@ public:
             exit(1);
         }
 
-        shm_size = 2056;
+        shm_size = tracksSegmentSize(trackCapacity);
         if (ftruncate(aircraftShmFd, shm_size) == -1)
         {
             perror("Error setting shared memory size");
@@ -171,7 +188,7 @@ public:
             exit(1);
         }
 
-        aircraftShmPtr = mmap(0, shm_size, PROT_WRITE, MAP_SHARED, aircraftShmFd, 0);
+        aircraftShmPtr = mmap(0, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, aircraftShmFd, 0);
         if (aircraftShmPtr == MAP_FAILED)
         {
             perror("Error mapping shared memory");
@@ -179,17 +196,27 @@ public:
             exit(1);
         }
 
+        // Start with no tracks
         memset(aircraftShmPtr, 0, shm_size);
+        TracksHeader *tracksHeader = static_cast<TracksHeader *>(aircraftShmPtr);
+        tracksHeader->magic = TRACKS_MAGIC;
+        tracksHeader->version = TRACKS_VERSION;
+        tracksHeader->capacity = trackCapacity;
+        tracksHeader->count = 0;
+        tracksHeader->generation = 0;
+        tracksHeader->deltaCapacity = trackCapacity * TRACK_DELTAS_PER_TRACK;
+        tracksHeader->keyframeSequence = 0;
+        tracksHeader->deltaSequence = 0;
 
         // Initialize shared memory and semaphore for operator commands
-        shm_fd_logs = shm_open(SHARED_MEMORY_LOGS, O_RDONLY, 0666);
+        shm_fd_logs = shm_open(SHARED_MEMORY_LOGS, O_RDWR, 0666);
         if (shm_fd_logs == -1)
         {
             perror("shm_open() for logs failed");
             exit(1);
         }
 
-        shm_ptr_logs = mmap(0, SHM_SIZE, PROT_READ, MAP_SHARED, shm_fd_logs, 0);
+        shm_ptr_logs = mmap(0, COMMAND_RING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_logs, 0); // The Computer moves the tail of the ring
         if (shm_ptr_logs == MAP_FAILED)
         {
             perror("mmap() for logs failed");
@@ -242,7 +269,7 @@ public:
             exit(1);
         }
 
-        if (ftruncate(shm_fd_comm, COMM_SHM_SIZE) == -1)
+        if (ensureSegmentSize(shm_fd_comm, COMM_SHM_SIZE) == -1) // The speed changes of the Communication subsystem follow the command
         {
             perror("ftruncate() for communication failed");
             exit(1);
@@ -269,39 +296,26 @@ public:
             exit(1);
         }
 
-        if (ftruncate(shm_fd_alerts, SHM_SIZE) == -1)
+        if (ftruncate(shm_fd_alerts, ALERTS_SHM_SIZE) == -1)
         {
             perror("ftruncate() for alerts failed");
             exit(1);
         }
 
-        shm_ptr_alerts = mmap(0, SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_alerts, 0);
+        shm_ptr_alerts = mmap(0, ALERTS_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_alerts, 0);
         if (shm_ptr_alerts == MAP_FAILED)
         {
             perror("mmap() for alerts failed");
             exit(1);
         }
 
-        // Initialize shared memory for aircraft data
-        shm_fd_aircrafts = shm_open(AIRCRAFT_SHARED_MEMORY_NAME, O_CREAT | O_RDWR, 0666);
-        if (shm_fd_aircrafts == -1)
-        {
-            perror("shm_open() for aircraft data failed");
-            exit(1);
-        }
-
-        if (ftruncate(shm_fd_aircrafts, SHM_SIZE) == -1)
-        {
-            perror("ftruncate() for aircraft data failed");
-            exit(1);
-        }
-
-        shm_ptr_aircrafts = mmap(0, SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_aircrafts, 0);
-        if (shm_ptr_aircrafts == MAP_FAILED)
-        {
-            perror("mmap() for aircraft data failed");
-            exit(1);
-        }
+        // Start an empty ring of alerts
+        memset(shm_ptr_alerts, 0, ALERTS_SHM_SIZE);
+        AlertsHeader *alertsHeader = static_cast<AlertsHeader *>(shm_ptr_alerts);
+        alertsHeader->magic = ALERTS_MAGIC;
+        alertsHeader->version = ALERTS_VERSION;
+        alertsHeader->capacity = ALERT_CAPACITY;
+        alertsHeader->sequence = 0;
 
         shm_fd_augmentedInfo = shm_open(AUGMENTED_INFO_MEMORY_NAME, O_CREAT | O_RDWR, 0666);
         if (shm_fd_augmentedInfo == -1)
@@ -343,7 +357,7 @@ public:
         cleanupSemaphores();
         if (shm_ptr_logs)
         {
-            munmap(shm_ptr_logs, SHM_SIZE);
+            munmap(shm_ptr_logs, COMMAND_RING_SIZE);
         }
         if (shm_fd_logs != -1)
         {
@@ -408,29 +422,57 @@ public:
     void run()
     {
         terminate = false;
-        thread radarThread(&Computer::updateFromRadar, this);
-        thread violationThread(&Computer::checkViolationsAndAlerts, this);
-        thread loggingThread(&Computer::logAircraftData, this);
+        openRadarSegment();
+
+        // The periodic tasks of the simulation share the workers of the executor, by rate-monotonic priority. The
+        // operator commands and the conflict calendar are not periodic, they wake up on their own events, and the
+        // termination signal is polled on the wall clock, so it is seen even while the simulation is slow or paused.
+        executor.addTask("radar update", RADAR_UPDATE_PERIOD, RADAR_UPDATE_PERIOD, 6, [this]
+                         { updateFromRadar(); });
+        executor.addTask("aircraft data", RADAR_UPDATE_PERIOD, RADAR_UPDATE_PERIOD, 5, [this]
+                         { sendAircrafts(); });
+        executor.addTask("violations", VIOLATION_CHECK_PERIOD, VIOLATION_CHECK_PERIOD, 4, [this]
+                         { checkViolationsAndAlerts(); });
+        executor.addTask("history", HISTORY_LOG_PERIOD, HISTORY_LOG_PERIOD, 1, [this]
+                         { logAircraftData(); });
+
         thread operatorThread(&Computer::processOperatorCommands, this);
-        thread aircraftThread(&Computer::aircraftDataThread, this);
-        thread alertsThread(&Computer::alertsDataThread, this);
+        thread calendarThread(&Computer::conflictCalendarThread, this);
         thread terminationThread(&Computer::terminationHandling, this, sem_term, shm_ptr_term, ref(terminate));
 
-        radarThread.join();
-        violationThread.join();
-        loggingThread.join();
+        executor.run(terminate);
+
         operatorThread.join();
-        aircraftThread.join();
-        alertsThread.join();
+        calendarThread.join();
         terminationThread.join();
+        closeRadarSegment();
+
+        taskMetrics.print(cout); // Timing of every task over the whole run
     }
 
 private:
-    vector<Aircraft> aircrafts;
+    TrackStore trackStore;                                 // Tracks kept between radar updates, with the generation of their last change
+    vector<Aircraft> &aircrafts = trackStore.getAircrafts(); // Tracks indexed by the conflict checks
 
     priority_queue<Alert> alerts;
+    // Violation that has not ended yet
+    struct ActiveViolation
+    {
+        time_t firstSeen;  // Time at which the violation was first seen
+        uint64_t lastScan; // Last scan that found the violation
+    };
+    unordered_map<uint64_t, ActiveViolation> activeViolations; // Pairs in violation, by pair of aircraft IDs
+    uint64_t violationScan = 0;                                // Number of scans for violations
+    unordered_set<uint64_t> sentAlerts;                        // Pairs and kinds already written in the current batch of alerts
     mutex alertMutex;
     atomic<bool> terminate;
+    SimClock simClock;         // Time of the airspace, driven by the Radar
+    PeriodicExecutor executor; // Runs the periodic tasks on the simulation clock, declared after it
+    size_t radarSize = 0;                 // Size of the radar shared memory
+    vector<SharedAircraft> radarSnapshot; // Live aircrafts of the radar
+    vector<size_t> changedTracks;         // Tracks changed by the last radar update
+    vector<int> removedIDs;               // Aircrafts that left on the last radar update
+    size_t tornReads = 0;                 // Copies of the radar table retried because the Radar was updating it
     sem_t *radarSemaphore;
     sem_t *alertsSemaphore;
     sem_t *communicationSemaphore;
@@ -438,7 +480,52 @@ private:
     int aircraftShmFd;
     void *aircraftShmPtr;
     size_t shm_size;
+    uint32_t trackCapacity; // Number of track records in the aircraft data shared memory
+    uint64_t publishedGeneration = 0; // Generation of the track store last published to the Visual Display
+    uint64_t publications = 0;        // Number of times the tracks were published
+    vector<size_t> publishedTracks;   // Tracks changed since the last publication
+    vector<int> publishedRemovals;    // Aircrafts that left since the last publication
     ofstream logFile;
+    SpatialGrid violationGrid;             // Broad phase for the separation checks
+    SweepAndPrune collisionSweep;           // Broad phase for the collision checks
+    unordered_set<uint64_t> violatingPairs; // Pairs already in violation during the current cycle
+    TrackTable tracks;                      // Structure of arrays copy of the aircrafts for the conflict kernel
+    vector<pair<int, int>> collisionPairs;  // Candidate pairs of the collision broad phase
+    vector<size_t> collisionTiles;          // First candidate pair of every tile, followed by the end of the last tile
+    WorkStealingPool conflictPool;          // Runs the tiles of the collision narrow phase
+
+    PredictionCache predictions;            // Collision roots of the candidate pairs, kept between cycles
+    double snapshotTime = 0;                // Time of the last radar update, on the simulation clock
+    Doorbell operatorDoorbell{OPERATOR_DOORBELL};           // Rung by the Operator once it has written a command
+    Doorbell communicationDoorbell{COMMUNICATION_DOORBELL}; // Rung once a command is written for the Communication subsystem
+    HopLatency &operatorHop = taskMetrics.addHop("Operator -> Computer"); // Printed with the task metrics
+
+    // Collision found by one of the conflict workers
+    struct PredictedCollision
+    {
+        int first;  // Index of the first aircraft in the aircrafts vector
+        int second; // Index of the second aircraft in the aircrafts vector
+        double time;
+    };
+
+    // Roots computed by one of the conflict workers for a pair missing from the prediction cache
+    struct NewPrediction
+    {
+        int first;
+        int second;
+        CollisionRoots roots;
+    };
+
+    // Buffers owned by a single conflict worker, so the workers never share memory while they run
+    struct ConflictWorkerState
+    {
+        vector<int> batchOthers;               // Aircrafts tested against the same aircraft in one batch
+        vector<CollisionRoots> batchRoots;     // Roots computed by the conflict kernel
+        vector<PredictedCollision> collisions; // Local alert buffer, merged into the alerts queue after the tiles are done
+        vector<NewPrediction> newPredictions;  // Local buffer of roots, merged into the prediction cache after the tiles are done
+    };
+    vector<ConflictWorkerState> conflictWorkerStates;
+    ConflictCalendar calendar; // Predicted collisions, raised as alerts when their warning thresholds are crossed
 
     void cleanupSemaphores()
     {
@@ -467,196 +554,193 @@ private:
         shm_unlink(AIRCRAFT_SHARED_MEMORY_NAME);
     }
 
-    // Method used to communicate with the Radar Subsystem. Gets the data of all aircrafts
-    // Currently being stored in the system
-    void updateFromRadar()
+    // Maps the shared memory of the Radar Subsystem, before the tracks are updated from it.
+    void openRadarSegment()
     {
-        cout << "Initializing radar shared memory and semaphore..." << endl;
-
-        // Open the semaphore
-        sem_plane = sem_open(sem_name, O_CREAT, 0777, 1);
-        if (sem_plane == SEM_FAILED)
-        {
-            perror("Failed to open radar semaphore");
-            exit(EXIT_FAILURE);
-        }
+        asyncLog.log(LOG_INFO, "Initializing radar shared memory...");
 
         // Open the shared memory
         shm_fdd = shm_open(shared_name, O_RDWR, 0777);
         if (shm_fdd == -1)
         {
             perror("Failed to open radar shared memory");
-            sem_close(sem_plane);
             exit(EXIT_FAILURE);
         }
 
-        // Map the shared memory
-        sharedAircraftList = (SharedAircraft *)mmap(0, sizeof(SharedAircraft) * 10, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fdd, 0);
-        if (sharedAircraftList == MAP_FAILED)
+        // Map the shared memory, its size is read from its header
+        radarSegment = mapRadarSegment(shm_fdd, PROT_READ, radarSize);
+        if (radarSegment == MAP_FAILED)
         {
             perror("Failed to map radar shared memory");
-            sem_close(sem_plane);
             close(shm_fdd);
             exit(EXIT_FAILURE);
         }
 
-        cout << "Radar shared memory and semaphore initialized successfully." << endl;
-
-        // Periodically update the aircrafts vector with radar data
-        while (!terminate)
-        {
-            this_thread::sleep_for(chrono::seconds(5)); // Update every 5 seconds
+        asyncLog.log(LOG_INFO, "Radar shared memory initialized successfully ({} aircrafts).", static_cast<RadarHeader *>(radarSegment)->capacity);
+    }
 
-            sem_wait(sem_plane); // Lock the semaphore
+    // Method used to communicate with the Radar Subsystem. Gets the data of all aircrafts
+    // Currently being stored in the system, only the tracks that changed are touched
+    void updateFromRadar()
+    {
+        // Copy the radar table without blocking the Radar, the copy is retried if the Radar updates it meanwhile
+        uint64_t radarGeneration;
+        tornReads += readRadarSnapshot(radarSegment, radarSnapshot, &radarGeneration);
 
+        uint64_t before, generation;
+        {
+            lock_guard<mutex> lock(air_mutex); // Protect access to the tracks
+            lock_guard<mutex> aircraftlock(aircraftsMutex);
+            before = trackStore.getGeneration();
+            if (!trackStore.update(radarSnapshot, radarGeneration))
             {
-                lock_guard<mutex> lock(air_mutex); // Protect access to the aircrafts vector
-                lock_guard<mutex> aircraftlock(aircraftsMutex);
-                // Clear the current aircraft list
-                aircrafts.clear();
-
-                // Read data from shared memory and populate the aircrafts vector
-                for (int i = 0; i < 8; i++)
-                { // Assuming a maximum of 8 aircrafts
-                    SharedAircraft &radarAircraft = sharedAircraftList[i];
-
-                    // Skip empty or uninitialized entries
-                    if (radarAircraft.aircraftID == 0)
-                    {
-                        continue;
-                    }
-
-                    // Convert SharedAircraft to Aircraft and add to the vector
-                    aircrafts.emplace_back(
-                        radarAircraft.startTime,
-                        radarAircraft.aircraftID,
-                        radarAircraft.positionX,
-                        radarAircraft.positionY,
-                        radarAircraft.positionZ,
-                        radarAircraft.speedX,
-                        radarAircraft.speedY,
-                        radarAircraft.speedZ,
-                        0);
-                }
+                return; // The radar table has not changed
             }
-
-            sem_post(sem_plane); // Unlock the semaphore
-
-            cout << "Aircraft data updated from radar." << endl;
+            snapshotTime = simClock.now();
+            generation = trackStore.getGeneration();
+            trackStore.changedSince(before, changedTracks, removedIDs);
+            systemMetrics.set(COMPUTER_TRACKS, aircrafts.size());
         }
+        systemMetrics.add(COMPUTER_RADAR_UPDATES);
 
-        // Cleanup shared memory and semaphore
-        munmap(sharedAircraftList, sizeof(SharedAircraft) * 10);
+        asyncLog.log(LOG_INFO, "Aircraft data updated from radar: generation {}, {} tracks changed, {} left ({} torn reads retried so far).",
+                     generation, changedTracks.size(), removedIDs.size(), tornReads);
+    }
+
+    void closeRadarSegment()
+    {
+        munmap(radarSegment, radarSize);
         close(shm_fdd);
-        sem_close(sem_plane);
     }
 
-    // Checking to terminate the system
+    // Checking to terminate the system, every TERMINATION_CHECK_PERIOD seconds of real time
     void terminationHandling(sem_t *sem_term, void *shm_ptr_term, atomic<bool> &terminate)
     {
+        TaskMetrics &metrics = taskMetrics.add("termination");
         while (!terminate)
         {
-            sem_wait(sem_term);
+            {
+                ScopedTaskTimer timer(metrics);
+                sem_wait(sem_term);
 
-            // Read the termination signal from shared memory
-            char *terminationSignal = static_cast<char *>(shm_ptr_term);
-            string terminationSignalString(terminationSignal);
+                // Read the termination signal from shared memory
+                char *terminationSignal = static_cast<char *>(shm_ptr_term);
+                string terminationSignalString(terminationSignal);
 
-            // Check if the signal is "Terminate"
-            if (terminationSignalString == "Terminate")
-            {
-                terminate = true; // Set the termination flag
-                cout << "Termination signal received. Shutting down..." << endl;
+                // Check if the signal is "Terminate"
+                if (terminationSignalString == "Terminate")
+                {
+                    terminate = true; // Set the termination flag
+                    asyncLog.log(LOG_INFO, "Termination signal received. Shutting down...");
+                }
+
+                sem_post(sem_term); // Unlock the semaphore
             }
 
-            sem_post(sem_term); // Unlock the semaphore
-            this_thread::sleep_for(chrono::seconds(10));
+            if (!terminate)
+            {
+                this_thread::sleep_for(duration<double>(TERMINATION_CHECK_PERIOD));
+            }
         }
     }
 
-    // This method writes every 20 seconds in a History.log function
+    // This method writes the tracks in a History.log function, every HISTORY_LOG_PERIOD seconds
     void logAircraftData()
     {
-        while (!terminate)
+        lock_guard<mutex> lock(alertMutex);
+        lock_guard<mutex> aircraftslock(aircraftsMutex); // The radar update replaces the aircrafts
+        logFile << "Logging aircraft data..." << endl;
+        for (auto &aircraft : aircrafts)
         {
-            this_thread::sleep_for(chrono::seconds(20));
-
-            lock_guard<mutex> lock(alertMutex);
-            logFile << "Logging aircraft data..." << endl;
-            for (auto &aircraft : aircrafts)
-            {
-                logFile << "Aircraft ID: " << aircraft.getAircraftID()
-                        << ", Position: (" << aircraft.getPositionX() << ", "
-                        << aircraft.getPositionY() << ", " << aircraft.getPositionZ() << ")"
-                        << ", Velocity: (" << aircraft.getSpeedX() << ", "
-                        << aircraft.getSpeedY() << ", " << aircraft.getSpeedZ() << ")" << endl;
-            }
+            logFile << "Aircraft ID: " << aircraft.getAircraftID()
+                    << ", Position: (" << aircraft.getPositionX() << ", "
+                    << aircraft.getPositionY() << ", " << aircraft.getPositionZ() << ")"
+                    << ", Velocity: (" << aircraft.getSpeedX() << ", "
+                    << aircraft.getSpeedY() << ", " << aircraft.getSpeedZ() << ")" << endl;
         }
     }
 
-    // Taking commands from the operator file, sending them wherever they need to go. This command reads the shared memory
-    // from the operator, and then checks if an airplane's speeds are changing, or if there is a
+    // Taking commands from the operator file, sending them wherever they need to go. This command reads the ring of commands
+    // from the operator, and then checks if an airplane's speeds are changing, or if augmented information is requested
     void processOperatorCommands()
     {
+        CommandRing commands(shm_ptr_logs);
+        vector<OperatorCommand> pending; // Commands taken from the ring on the last wake-up
+        TaskMetrics &metrics = taskMetrics.add("operator commands");
+
         while (!terminate)
         {
-            this_thread::sleep_for(chrono::seconds(1)); // Periodic task
-
-            sem_wait(sem_logs); // Lock semaphore for logs
+            // Woken as soon as the Operator writes a command, the timeout keeps checking for termination
+            operatorDoorbell.wait(1.0);
 
-            // Read the command from shared memory
-            string command(static_cast<char *>(shm_ptr_logs));
-
-            if (!command.empty())
+            // Every command written since the last wake-up is handled, none is lost if several came at once
+            pending.clear();
+            size_t skipped = commands.drain(pending);
+            if (pending.empty() && skipped == 0)
             {
-                cout << "Processing operator command: " << command << endl;
-
-                // Parse the command
-                istringstream iss(command);
-                string commandType, aircraftID;
-                iss >> commandType >> aircraftID;
+                continue; // Woken by the timeout, which is not a run of the task
+            }
+            ScopedTaskTimer timer(metrics);
+            if (skipped > 0)
+            {
+                asyncLog.log(LOG_WARNING, "{} operator commands were out of sequence and skipped.", skipped);
+            }
+            systemMetrics.add(COMPUTER_COMMANDS, pending.size());
 
-                string communicationMessage;
-                cout << commandType << " is the type of command" << endl;
+            for (const OperatorCommand &command : pending)
+            {
+                operatorHop.record(command.issuedAt);
+                asyncLog.log(LOG_INFO, "Processing operator command {} for aircraft {}", command.sequence, command.aircraftID);
 
-                if (commandType == "Speed_Change")
+                if (command.kind == COMMAND_SPEED_CHANGE)
                 {
-                    int newSpeedX, newSpeedY, newSpeedZ;
-                    iss >> newSpeedX >> newSpeedY >> newSpeedZ;
-                    communicationMessage = aircraftID + " " +
-                                           to_string(newSpeedX) + " " +
-                                           to_string(newSpeedY) + " " +
-                                           to_string(newSpeedZ);
+                    string communicationMessage = to_string(command.aircraftID) + " " +
+                                                  to_string(command.speedX) + " " +
+                                                  to_string(command.speedY) + " " +
+                                                  to_string(command.speedZ) + " " +
+                                                  to_string(command.issuedAt) + " " +
+                                                  to_string(monotonicNanoseconds());
 
                     sendToCommunication(communicationMessage);
                 }
-                else if (commandType == "Augmented_Information")
+                else if (command.kind == COMMAND_AUGMENTED_INFORMATION)
                 {
-                    int id = stoi(aircraftID);
-                    augmentInformation(id);
+                    augmentInformation(command.aircraftID);
+                }
+                else
+                {
+                    asyncLog.log(LOG_WARNING, "Unknown operator command kind {}", command.kind);
                 }
-
-                // Clear the shared memory for logs after processing the command
-                memset(shm_ptr_logs, 0, SHM_SIZE);
-                cout << "Shared memory for logs cleared after processing command." << endl;
             }
-
-            sem_post(sem_logs); // Unlock semaphore for logs
         }
     }
 
     // Method which writes to the communication subsystem when a speed change is made to an aircraft
     void sendToCommunication(const string &command)
     {
+        char *mem = static_cast<char *>(shm_ptr_comm);
+
+        // The Communication subsystem clears the command once it has read it. Commands can now come faster
+        // than one per wake-up of the Communication subsystem, so the previous one is not overwritten.
         sem_wait(sem_comm);
+        for (int attempt = 0; mem[0] != '\0' && attempt < COMMUNICATION_WAIT_ATTEMPTS && !terminate; attempt++)
+        {
+            sem_post(sem_comm);
+            this_thread::sleep_for(microseconds(100));
+            sem_wait(sem_comm);
+        }
+        if (mem[0] != '\0')
+        {
+            asyncLog.log(LOG_WARNING, "Communication subsystem is not reading, overwriting its last command.");
+        }
+
         // Write the message to shared memory
-        char *mem = static_cast<char *>(shm_ptr_comm);
-        memset(mem, 0, COMM_SHM_SIZE); // Clear the shared memory
+        memset(mem, 0, COMMAND_AREA_SIZE); // Clear the previous command, but not the speed changes that follow it
 
         // Ensure we don't exceed the shared memory size
-        if (command.size() >= COMM_SHM_SIZE)
+        if (command.size() >= COMMAND_AREA_SIZE)
         {
-            cerr << "Shared memory full, unable to write communication message." << endl;
+            asyncLog.log(LOG_ERROR, "Shared memory full, unable to write communication message.");
             sem_post(sem_comm); // Unlock semaphore
             return;
         }
@@ -664,117 +748,324 @@ private:
         memcpy(mem, command.c_str(), command.size());
 
         sem_post(sem_comm);
+        communicationDoorbell.ring();
     }
 
     // Checks for violations in the system by checking all aircraft distances and trajectories.
     void checkViolationsAndAlerts()
     {
-        while (!terminate)
+        lock_guard<mutex> lock(alertMutex); // Protect access to the alerts queue
+        lock_guard<mutex> aircraftslock(aircraftsMutex);
+
+        steady_clock::time_point cycleStart = steady_clock::now();
+        size_t violationPairsTested = 0;
+        size_t collisionPairsTested = 0;
+
+        // Only aircrafts in neighbouring cells of the grid can be closer than the separation minima.
+        trackStore.beginViolationScan();
+        violationGrid.build(aircrafts);
+        violatingPairs.clear();
+        time_t scanTime = time(nullptr);
+        violationScan++;
+        violationGrid.forEachCandidatePair([&](int i, int j)
+                                           {
+            violationPairsTested++;
+            Aircraft &a1 = aircrafts[i];
+            Aircraft &a2 = aircrafts[j];
+
+            // Check for separation violations
+            if (violationCheck(&a1, &a2))
+            {
+                a1.setIsViolation(1);
+                a2.setIsViolation(1);
+                violatingPairs.insert(pairIndex(i, j));
+
+                // Only the start of a violation raises an alert, it is suppressed while the violation lasts.
+                uint64_t key = pairKey(a1.getAircraftID(), a2.getAircraftID());
+                auto [violation, started] = activeViolations.try_emplace(key, ActiveViolation{scanTime, violationScan});
+                violation->second.lastScan = violationScan;
+                if (started)
+                {
+                    alerts.push(makeAlert(ALERT_SEPARATION_VIOLATION, a1.getAircraftID(), a2.getAircraftID(), 0, scanTime));
+                }
+            } });
+
+        // Violations that were not seen again have ended.
+        for (auto it = activeViolations.begin(); it != activeViolations.end();)
+        {
+            if (it->second.lastScan != violationScan)
+            {
+                it = activeViolations.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Only aircrafts whose swept boxes overlap can collide inside the look-ahead window.
+        collisionSweep.build(aircrafts);
+        collisionPairs.clear();
+        collisionSweep.forEachCandidatePair([&](int i, int j)
+                                            {
+            if (!violatingPairs.count(pairIndex(i, j)))
+            {
+                collisionPairs.emplace_back(i, j);
+            } });
+        sort(collisionPairs.begin(), collisionPairs.end());
+        collisionPairsTested = collisionPairs.size();
+
+        // Split the candidate pairs into tiles, without splitting the pairs of one aircraft across tiles.
+        collisionTiles.clear();
+        for (size_t k = 0; k < collisionPairs.size(); k++)
+        {
+            bool newAircraft = (k == 0) || (collisionPairs[k].first != collisionPairs[k - 1].first);
+            if (newAircraft && (collisionTiles.empty() || k - collisionTiles.back() >= CONFLICT_TILE_PAIRS))
+            {
+                collisionTiles.push_back(k);
+            }
+        }
+        collisionTiles.push_back(collisionPairs.size());
+
+        // Check for potential collisions on the conflict pool, testing each aircraft against all of its candidates in one batch.
+        steady_clock::time_point kernelStart = steady_clock::now();
+        tracks.load(aircrafts);
+        predictions.beginCycle(aircrafts);
+        uint64_t hitsBefore = predictions.getHits();
+        uint64_t invalidationsBefore = predictions.getInvalidations();
+        conflictWorkerStates.resize(max<size_t>(conflictPool.getWorkerCount(), 1));
+        conflictPool.run(collisionTiles.size() - 1, [this](size_t tile, size_t worker)
+                         { checkCollisionTile(collisionTiles[tile], collisionTiles[tile + 1], conflictWorkerStates[worker]); });
+
+        // Merge the local alert buffers of the workers into the conflict calendar, which raises the alerts when they are due.
+        double now = simClock.now();
+        calendar.beginScan();
+        for (ConflictWorkerState &state : conflictWorkerStates)
         {
-            this_thread::sleep_for(chrono::seconds(3)); // Periodic task every 5 seconds
+            for (PredictedCollision &collision : state.collisions)
+            {
+                Aircraft &a1 = aircrafts[collision.first];
+                Aircraft &a2 = aircrafts[collision.second];
+                calendar.predict(a1.getAircraftID(), a2.getAircraftID(),
+                                 predictions.getEpoch(collision.first), predictions.getEpoch(collision.second),
+                                 snapshotTime + collision.time, now);
+                a1.setIsViolation(1);
+                a2.setIsViolation(1);
+            }
+            state.collisions.clear();
 
-            lock_guard<mutex> lock(alertMutex); // Protect access to the alerts queue
-            lock_guard<mutex> aircraftslock(aircraftsMutex);
+            for (NewPrediction &prediction : state.newPredictions)
+            {
+                predictions.store(aircrafts, prediction.first, prediction.second, snapshotTime, prediction.roots);
+            }
+            state.newPredictions.clear();
+        }
+        predictions.endCycle();
+        calendar.endScan();
+        trackStore.endViolationScan();
+        duration<double> kernelTime = steady_clock::now() - kernelStart;
+
+        duration<double, milli> cycleTime = steady_clock::now() - cycleStart;
+        systemMetrics.add(COMPUTER_SEPARATION_PAIRS, violationPairsTested);
+        systemMetrics.add(COMPUTER_COLLISION_PAIRS, collisionPairsTested);
+        asyncLog.log(LOG_INFO, "Violation cycle: {} aircrafts, {} cells, {} separation pairs, {} collision pairs ({} pairs/s on {} workers, {} tiles), "
+                               "{} cache hits, {} invalidations, {} ms",
+                     aircrafts.size(), violationGrid.getOccupiedCells(), violationPairsTested, collisionPairsTested,
+                     (kernelTime.count() > 0 ? collisionPairsTested / kernelTime.count() : 0.0),
+                     conflictPool.getWorkerCount(), collisionTiles.size() - 1,
+                     predictions.getHits() - hitsBefore, predictions.getInvalidations() - invalidationsBefore, cycleTime.count());
+
+        // Send alerts to data display
+        sendAlertsToDataDisplay();
+    }
 
-            for (size_t i = 0; i < aircrafts.size(); ++i)
+    // Checks the candidate pairs [begin, end), which are sorted by their first aircraft. Pairs found in the
+    // prediction cache reuse their roots, the others are solved by the conflict kernel in one batch per aircraft.
+    void checkCollisionTile(size_t begin, size_t end, ConflictWorkerState &state)
+    {
+        while (begin < end)
+        {
+            int i = collisionPairs[begin].first;
+            state.batchOthers.clear();
+
+            for (; begin < end && collisionPairs[begin].first == i; begin++)
             {
-                for (size_t j = i + 1; j < aircrafts.size(); ++j)
+                int j = collisionPairs[begin].second;
+                CachedPrediction *cached = predictions.find(aircrafts, i, j);
+                if (cached == nullptr)
+                {
+                    state.batchOthers.push_back(j);
+                    continue;
+                }
+
+                double collisionTime = firstAlertFromRoots(cached->roots, snapshotTime - cached->referenceTime, COLLISION_LOOKAHEAD);
+                if (collisionTime >= 0)
                 {
-                    Aircraft &a1 = aircrafts[i];
-                    Aircraft &a2 = aircrafts[j];
-
-                    // Check for separation violations
-                    if (violationCheck(&a1, &a2))
-                    {
-                        alerts.push({0, "Separation violation detected between " + to_string(a1.getAircraftID()) + " and " + to_string(a2.getAircraftID())});
-                        a1.setIsViolation(1);
-                        a2.setIsViolation(1);
-                        cout << "violation found. " << endl;
-                    }
-                    else
-                    {
-
-                        // Check for potential collisions
-                        auto [collisionDetected, collisionTime] = collisionCheck(&a1, &a2);
-                        if (collisionDetected)
-                        {
-                            alerts.push({collisionTime, "Collision will occur in " + to_string(collisionTime) + " seconds between " + to_string(a1.getAircraftID()) + " and " + to_string(a2.getAircraftID())});
-                            a1.setIsViolation(1);
-                            a2.setIsViolation(1);
-                        }
-                    }
+                    state.collisions.push_back({i, j, collisionTime});
                 }
             }
 
-            // Send alerts to data display
-            sendAlertsToDataDisplay();
+            state.batchRoots.resize(state.batchOthers.size());
+            collisionRootsBatch(tracks, i, state.batchOthers.data(), state.batchOthers.size(), HORIZONTAL_SEPARATION, VERTICAL_SEPARATION, state.batchRoots.data());
+
+            for (size_t k = 0; k < state.batchOthers.size(); k++)
+            {
+                double collisionTime = firstAlertFromRoots(state.batchRoots[k], 0, COLLISION_LOOKAHEAD);
+                if (collisionTime >= 0)
+                {
+                    state.collisions.push_back({i, state.batchOthers[k], collisionTime});
+                }
+                state.newPredictions.push_back({i, state.batchOthers[k], state.batchRoots[k]});
+            }
         }
     }
 
+    // Builds an alert record, the sequence number is given when the alert is written to shared memory.
+    Alert makeAlert(AlertKind kind, int idA, int idB, double timeToConflict, time_t firstSeen)
+    {
+        Alert alert = {};
+        alert.kind = kind;
+        alert.firstID = min(idA, idB);
+        alert.secondID = max(idA, idB);
+        alert.timeToConflict = static_cast<float>(timeToConflict);
+        alert.firstSeen = firstSeen;
+        return alert;
+    }
+
+    // Unique key of an unordered pair of aircraft IDs.
+    static uint64_t pairKey(int idA, int idB)
+    {
+        return (uint64_t(uint32_t(min(idA, idB))) << 32) | uint32_t(max(idA, idB));
+    }
+
+    // Unique index of an unordered pair of aircrafts in the aircrafts vector.
+    uint64_t pairIndex(size_t i, size_t j)
+    {
+        return (uint64_t(min(i, j)) << 32) | uint64_t(max(i, j));
+    }
+
     // Sends aircraft data to the visual display subsystem.
     void sendAircrafts()
     {
-        sem_wait(dataDisplaySemaphore); // Lock semaphore for aircraft data
-
+        // Same order as the violation scan, which sends the alerts while it holds the tracks
         lock_guard<mutex> lock(aircraftsMutex); // Protect access to aircraft shared memory
 
-        // Clear the shared memory for aircraft data
-        memset(shm_ptr_aircrafts, 0, SHM_SIZE);
+        lockDataDisplay(); // Lock semaphore for aircraft data
 
-        // Write aircraft data to shared memory
-        char *mem = static_cast<char *>(shm_ptr_aircrafts);
-        for (auto &aircraft : aircrafts)
+        TracksHeader *header = static_cast<TracksHeader *>(aircraftShmPtr);
+        TrackDelta *deltas = trackDeltas(aircraftShmPtr);
+        uint32_t deltaCapacity = header->deltaCapacity;
+
+        // The changes are sent as deltas when the track store still knows them, they fit in the ring, and
+        // a reader that starts from the keyframe can still find every delta that follows it.
+        bool known = trackStore.changedSince(publishedGeneration, publishedTracks, publishedRemovals);
+        size_t changes = publishedTracks.size() + publishedRemovals.size();
+        bool fits = known && header->deltaSequence - header->keyframeSequence + changes <= deltaCapacity;
+        size_t bytesWritten = sizeof(TracksHeader);
+        if (fits)
         {
-            string data = to_string(aircraft.getAircraftID()) + " " +
-                          to_string(aircraft.getPositionX()) + " " +
-                          to_string(aircraft.getPositionY()) + " " +
-                          to_string(aircraft.getPositionZ()) + " " +
-                          to_string(aircraft.getIsViolation()) + "\n";
+            bytesWritten += changes * sizeof(TrackDelta);
+            for (size_t i : publishedTracks)
+            {
+                TrackDelta &delta = deltas[(header->deltaSequence + 1) % deltaCapacity];
+                delta.sequence = ++header->deltaSequence;
+                delta.track = makeTrackRecord(aircrafts[i]);
+                delta.kind = TRACK_UPDATED;
+            }
+            for (int aircraftID : publishedRemovals)
+            {
+                TrackDelta &delta = deltas[(header->deltaSequence + 1) % deltaCapacity];
+                delta.sequence = ++header->deltaSequence;
+                delta.track = {};
+                delta.track.aircraftID = aircraftID;
+                delta.kind = TRACK_REMOVED;
+            }
+        }
+        else
+        {
+            // The readers that are not up to date fall further behind than the ring holds, and copy the keyframe.
+            header->deltaSequence += deltaCapacity + 1;
+        }
 
-            // Ensure we don't exceed the shared memory size
-            if (mem + data.size() > static_cast<char *>(shm_ptr_aircrafts) + SHM_SIZE)
+        bool keyframe = !fits || publications % KEYFRAME_INTERVAL == 0;
+        if (keyframe)
+        {
+            // Write one track record per aircraft to the keyframe
+            TrackRecord *records = trackRecords(aircraftShmPtr);
+            size_t count = min(aircrafts.size(), size_t(trackCapacity));
+            if (count < aircrafts.size())
             {
-                cerr << "Shared memory full, unable to write more aircraft data." << endl;
-                break;
+                asyncLog.log(LOG_WARNING, "Shared memory full, unable to write {} more aircrafts.", aircrafts.size() - count);
             }
 
-            memcpy(mem, data.c_str(), data.size());
-            mem += data.size();
+            for (size_t i = 0; i < count; i++)
+            {
+                records[i] = makeTrackRecord(aircrafts[i]);
+            }
+            header->count = count;
+            header->keyframeSequence = header->deltaSequence;
+            bytesWritten += count * sizeof(TrackRecord);
         }
+        header->generation++;
+        systemMetrics.add(COMPUTER_BYTES_WRITTEN, bytesWritten);
+
+        asyncLog.log(LOG_INFO, "Aircraft data sent to shared memory: {} deltas{}.", fits ? changes : 0, keyframe ? " and a keyframe" : "");
+        publishedGeneration = trackStore.getGeneration();
+        publications++;
 
         sem_post(dataDisplaySemaphore); // Unlock semaphore for aircraft data
     }
 
+    // Locks the semaphore shared with the Visual Display, the time spent waiting for it is published.
+    void lockDataDisplay()
+    {
+        uint64_t start = monotonicNanoseconds();
+        sem_wait(dataDisplaySemaphore);
+        systemMetrics.add(COMPUTER_SEMAPHORE_WAIT, monotonicNanoseconds() - start);
+    }
+
+    static TrackRecord makeTrackRecord(Aircraft &aircraft)
+    {
+        TrackRecord record = {};
+        record.positionX = aircraft.getPositionX();
+        record.positionY = aircraft.getPositionY();
+        record.positionZ = aircraft.getPositionZ();
+        record.aircraftID = aircraft.getAircraftID();
+        record.isViolation = aircraft.getIsViolation() ? 1 : 0;
+        return record;
+    }
+
     // Sends alerts to the visual display subsystem.
     void sendAlertsToDataDisplay()
     {
-        sem_wait(dataDisplaySemaphore); // Lock semaphore for data display
+        lockDataDisplay(); // Lock semaphore for data display
 
         lock_guard<mutex> lock(alertsMutex); // Protect access to alerts shared memory
 
-        // Clear the shared memory for alerts
-        memset(shm_ptr_alerts, 0, SHM_SIZE);
-
-        // Write alert data to shared memory
-        char *mem = static_cast<char *>(shm_ptr_alerts);
+        // Append the alerts to the ring in shared memory, most imminent first
+        AlertsHeader *header = static_cast<AlertsHeader *>(shm_ptr_alerts);
+        Alert *records = alertRecords(shm_ptr_alerts);
+        sentAlerts.clear();
+        size_t sent = 0;
         while (!alerts.empty())
         {
             Alert alert = alerts.top();
             alerts.pop();
 
-            string data = "ALERT: Time: " + to_string(alert.time) +
-                          ", Message: " + alert.message + "\n";
-
-            // Ensure we don't exceed the shared memory size
-            if (mem + data.size() > static_cast<char *>(shm_ptr_alerts) + SHM_SIZE)
+            // Only the most imminent alert of a pair is kept in a batch.
+            // Aircraft IDs have 8 digits, so the two top bits of the pair key are free for the kind.
+            if (!sentAlerts.insert((pairKey(alert.firstID, alert.secondID) << 2) | alert.kind).second)
             {
-                cerr << "Shared memory full, unable to write more alert data." << endl;
-                break;
+                continue;
             }
 
-            memcpy(mem, data.c_str(), data.size());
-            mem += data.size();
+            alert.sequence = header->sequence + 1;
+            records[alert.sequence % ALERT_CAPACITY] = alert;
+            header->sequence = alert.sequence;
+            sent++;
         }
+        systemMetrics.add(COMPUTER_ALERTS, sent);
+        systemMetrics.add(COMPUTER_BYTES_WRITTEN, sent * sizeof(Alert));
 
         sem_post(dataDisplaySemaphore); // Unlock semaphore for data display
     }
@@ -784,41 +1075,28 @@ private:
     {
         sem_wait(sem_augmentedInfo); // Lock semaphore for augmented info
 
-        lock_guard<mutex> lock(aircraftsMutex); // Protect access to the aircrafts vector
-
-        bool found = false;                 // Initialize found to false
-        Aircraft *targetAircraft = nullptr; // Pointer to the found aircraft
-
-        // Search for the aircraft in the vector
-        for (auto &aircraft : aircrafts)
-        {
-            if (aircraft.getAircraftID() == aircraftID)
-            {
-                found = true;
-                targetAircraft = &aircraft; // Store a pointer to the found aircraft
-                break;                      // Exit the loop once the ID is found
-            }
-        }
-
-        if (!found)
+        // Look the aircraft up in the registry of the Radar, which also gives its latest position. The record is
+        // only filled in when the aircraft is found, and only read after that.
+        SharedAircraft aircraft = {};
+        if (!radarSegment || !readRadarAircraft(radarSegment, aircraftID, aircraft))
         {
-            cerr << "Aircraft with ID " << aircraftID << " not found." << endl;
+            asyncLog.log(LOG_WARNING, "Aircraft with ID {} not found.", aircraftID);
             sem_post(sem_augmentedInfo); // Unlock semaphore
             return;
         }
 
         // Get the aircraft's information
-        Aircraft &aircraft = *targetAircraft; // Dereference the pointer to the found aircraft
-        string data = to_string(aircraft.getAircraftID()) + " " +
-                      to_string(aircraft.getPositionX()) + " " +
-                      to_string(aircraft.getPositionY()) + " " +
-                      to_string(aircraft.getPositionZ()) + " " +
-                      to_string(aircraft.getSpeedX()) + " " +
-                      to_string(aircraft.getSpeedY()) + " " +
-                      to_string(aircraft.getSpeedZ());
+        string data = to_string(aircraft.aircraftID) + " " +
+                      to_string(aircraft.positionX) + " " +
+                      to_string(aircraft.positionY) + " " +
+                      to_string(aircraft.positionZ) + " " +
+                      to_string(aircraft.speedX) + " " +
+                      to_string(aircraft.speedY) + " " +
+                      to_string(aircraft.speedZ);
 
         // Print the aircraft's information
-        cout << "Aircraft Data: " << data << endl;
+        asyncLog.log(LOG_INFO, "Aircraft Data: {} {} {} {} {} {} {}", aircraft.aircraftID, aircraft.positionX, aircraft.positionY, aircraft.positionZ,
+                     aircraft.speedX, aircraft.speedY, aircraft.speedZ);
 
         // Write the data to shared memory
         char *mem = static_cast<char *>(shm_ptr_augmentedInfo);
@@ -827,7 +1105,7 @@ private:
         // Ensure we don't exceed the shared memory size
         if (data.size() >= SHM_SIZE)
         {
-            cerr << "Shared memory full, unable to write augmented info." << endl;
+            asyncLog.log(LOG_ERROR, "Shared memory full, unable to write augmented info.");
             sem_post(sem_augmentedInfo); // Unlock semaphore
             return;
         }
@@ -835,7 +1113,7 @@ private:
         memcpy(mem, data.c_str(), data.size());
 
         sem_post(sem_augmentedInfo); // Unlock semaphore
-        cout << "Augmented info for aircraft " << aircraftID << " sent to shared memory." << endl;
+        asyncLog.log(LOG_INFO, "Augmented info for aircraft {} sent to shared memory.", aircraftID);
     }
 
     // Checks distance between aircrafts, used when looking for violations to report.
@@ -845,120 +1123,29 @@ private:
         double dy = abs(a1->getPositionY() - a2->getPositionY());
         double dz = abs(a1->getPositionZ() - a2->getPositionZ());
 
-        return ((dx < 3000 || dy < 3000) && dz < 1000);
-    }
-
-    // Checks for future violations found in the system with the aircraft trajectories.
-    tuple<bool, double> collisionCheck(Aircraft *a1, Aircraft *a2)
-    {
-        const int maxTime = 120;
-        const double horizontalThreshold = 3000.0;
-        const double verticalThreshold = 1000.0;
-
-        double dx0 = a1->getPositionX() - a2->getPositionX();
-        double dy0 = a1->getPositionY() - a2->getPositionY();
-        double dz0 = a1->getPositionZ() - a2->getPositionZ();
-        double dvx = a1->getSpeedX() - a2->getSpeedX();
-        double dvy = a1->getSpeedY() - a2->getSpeedY();
-        double dvz = a1->getSpeedZ() - a2->getSpeedZ();
-
-        double A = dvx * dvx + dvy * dvy;
-        double B = 2 * (dx0 * dvx + dy0 * dvy);
-        double C = dx0 * dx0 + dy0 * dy0;
-
-        double t_h_first = numeric_limits<double>::infinity();
-        double t_v_first = numeric_limits<double>::infinity();
-
-        bool horizontalValid = (A == 0) ? (sqrt(C) <= horizontalThreshold) : solveQuadraticFirstTime(A, B, C, horizontalThreshold, t_h_first);
-        bool verticalValid = solveLinearFirstTime(dz0, dvz, verticalThreshold, t_v_first);
-
-        if (!horizontalValid || !verticalValid)
-        {
-            return make_tuple(false, -1.0);
-        }
-
-        double t_first_alert = max(t_h_first, t_v_first);
-
-        if (t_first_alert <= maxTime)
-        {
-            return make_tuple(true, t_first_alert);
-        }
-
-        return make_tuple(false, -1.0);
-    }
-
-    // This and the subsequent method are used in collision calculations.
-    bool solveQuadraticFirstTime(double A, double B, double C, double R, double &t_first)
-    {
-        C -= R * R;
-
-        double discriminant = B * B - 4 * A * C;
-        if (discriminant < 0)
-            return false;
-
-        double sqrtD = sqrt(discriminant);
-        double t1 = (-B - sqrtD) / (2 * A);
-        double t2 = (-B + sqrtD) / (2 * A);
-
-        if (t1 >= 0)
-            t_first = t1;
-        else if (t2 >= 0)
-            t_first = t2;
-        else
-            return false;
-
-        return true;
+        return (dx < HORIZONTAL_SEPARATION && dy < HORIZONTAL_SEPARATION && dz < VERTICAL_SEPARATION);
     }
 
-    bool solveLinearFirstTime(double dz0, double dvz, double R, double &t_first)
+    // Raises the alerts of the conflict calendar as soon as they are due, and sleeps in between.
+    void conflictCalendarThread()
     {
-        if (dvz == 0)
+        TaskMetrics &metrics = taskMetrics.add("conflict calendar");
+        while (!terminate)
         {
-            if (abs(dz0) <= R)
+            // The timeout only bounds how long the termination flag goes unchecked.
+            vector<DueConflict> due = calendar.waitForDue(chrono::seconds(1));
+            if (due.empty())
             {
-                t_first = 0;
-                return true;
+                continue;
             }
-            else
+
+            ScopedTaskTimer timer(metrics);
+            lock_guard<mutex> lock(alertMutex);
+            for (DueConflict &conflict : due)
             {
-                return false;
+                alerts.push(makeAlert(ALERT_PREDICTED_COLLISION, conflict.firstID, conflict.secondID, conflict.timeToConflict, conflict.firstSeen));
             }
-        }
-
-        double t1 = (R - dz0) / dvz;
-        double t2 = (-R - dz0) / dvz;
-
-        if (t1 > t2)
-            swap(t1, t2);
-
-        if (t1 >= 0)
-            t_first = t1;
-        else if (t2 >= 0)
-            t_first = t2;
-        else
-            return false;
-
-        return true;
-    }
-
-    // Threads to run aircraft and alert data to send to the Visual display.
-    void aircraftDataThread()
-    {
-        while (!terminate)
-        {
-            this_thread::sleep_for(chrono::seconds(5)); // Update every 5 seconds
-            sendAircrafts();
-            cout << "Aircraft data sent to shared memory." << endl;
-        }
-    }
-
-    void alertsDataThread()
-    {
-        while (!terminate)
-        {
-            this_thread::sleep_for(chrono::seconds(5)); // Update every 5 seconds
-            // sendAlertsToDataDisplay();
-            cout << "Alerts sent to shared memory." << endl;
+            sendAlertsToDataDisplay();
         }
     }
 };
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <condition_variable>
+#include "SimClock.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: The conflict calendar holds the predicted losses of separation, ordered by the time at which
+    their next alert is due. Every prediction raises one alert when it is first scheduled, then one
+    more each time its time to conflict crosses one of the warning thresholds, down to the conflict
+    itself. A prediction is replaced when one of the aircrafts changes its speed, and cancelled when
+    the scan stops predicting it, so the calendar never raises an obsolete alert. */
+
+// Alert raised by the calendar when a warning threshold is crossed.
+struct DueConflict
+{
+    int firstID;
+    int secondID;
+    double timeToConflict; // Seconds left before the loss of separation.
+    time_t firstSeen;      // Time at which the conflict was first predicted.
+};
+
+class ConflictCalendar
+{
+public:
+    // Constructor, all times are in seconds of the simulation clock
+    ConflictCalendar(const SimClock &simulationClock, vector<double> warningThresholds) : clock(simulationClock)
+    {
+        thresholds = warningThresholds; // Sorted from the largest to the smallest.
+        nextVersion = 1;
+        scan = 0;
+    }
+
+    // Marks the beginning of a scan of the airspace.
+    void beginScan()
+    {
+        lock_guard<mutex> lock(calendarMutex);
+        scan++;
+    }
+
+    // Records that the scan predicts a loss of separation between two aircrafts at conflictTime. The epochs
+    // identify the speeds the prediction was computed with, a new epoch replaces the previous prediction.
+    void predict(int firstID, int secondID, uint32_t firstEpoch, uint32_t secondEpoch, double conflictTime, double now)
+    {
+        lock_guard<mutex> lock(calendarMutex);
+        if (firstID > secondID)
+        {
+            swap(firstID, secondID);
+            swap(firstEpoch, secondEpoch);
+        }
+        uint64_t key = pairKey(firstID, secondID);
+        auto found = conflicts.find(key);
+
+        if (found != conflicts.end() && found->second.firstEpoch == firstEpoch && found->second.secondEpoch == secondEpoch &&
+            abs(found->second.conflictTime - conflictTime) < SAME_CONFLICT_TOLERANCE)
+        {
+            found->second.lastScan = scan; // Already scheduled, nothing to do.
+            return;
+        }
+
+        // A replaced prediction is still the same conflict for the operator.
+        time_t firstSeen = (found != conflicts.end()) ? found->second.firstSeen : time(nullptr);
+
+        Conflict &conflict = conflicts[key];
+        conflict.firstSeen = firstSeen;
+        conflict.firstID = firstID;
+        conflict.secondID = secondID;
+        conflict.firstEpoch = firstEpoch;
+        conflict.secondEpoch = secondEpoch;
+        conflict.conflictTime = conflictTime;
+        conflict.version = nextVersion++; // Events of the previous prediction become obsolete.
+        conflict.lastScan = scan;
+
+        // The first alert is raised right away, the next ones when the following thresholds are crossed.
+        conflict.nextThreshold = 0;
+        while (conflict.nextThreshold < thresholds.size() && conflictTime - thresholds[conflict.nextThreshold] <= now)
+        {
+            conflict.nextThreshold++;
+        }
+        events.push({now, key, conflict.version});
+        wakeUp.notify_one();
+    }
+
+    // Marks the end of a scan, cancelling the predictions that the scan did not confirm.
+    void endScan()
+    {
+        lock_guard<mutex> lock(calendarMutex);
+        for (auto it = conflicts.begin(); it != conflicts.end();)
+        {
+            if (it->second.lastScan != scan)
+            {
+                it = conflicts.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Blocks until at least one alert is due, or until the timeout, and returns the alerts that are due.
+    vector<DueConflict> waitForDue(duration<double> timeout)
+    {
+        unique_lock<mutex> lock(calendarMutex);
+        steady_clock::time_point limit = steady_clock::now() + duration_cast<steady_clock::duration>(timeout);
+
+        while (true)
+        {
+            dropObsoleteEvents();
+            double now = clock.now();
+            if (!events.empty() && events.top().time <= now)
+            {
+                break;
+            }
+
+            steady_clock::time_point realNow = steady_clock::now();
+            if (realNow >= limit)
+            {
+                return {};
+            }
+
+            // The simulation clock may run faster than real time, so the wait is converted to real time.
+            steady_clock::time_point wakeTime = limit;
+            if (!events.empty())
+            {
+                wakeTime = min(wakeTime, realNow + duration_cast<steady_clock::duration>(clock.realDelay(events.top().time - now)));
+            }
+            wakeUp.wait_until(lock, wakeTime);
+        }
+
+        vector<DueConflict> due;
+        double now = clock.now();
+        while (!events.empty() && events.top().time <= now)
+        {
+            Event event = events.top();
+            events.pop();
+
+            auto found = conflicts.find(event.key);
+            if (found == conflicts.end() || found->second.version != event.version)
+            {
+                continue; // Cancelled or replaced.
+            }
+
+            Conflict &conflict = found->second;
+            due.push_back({conflict.firstID, conflict.secondID, max(conflict.conflictTime - now, 0.0), conflict.firstSeen});
+
+            // Schedule the alert of the next threshold.
+            if (conflict.nextThreshold < thresholds.size())
+            {
+                events.push({conflict.conflictTime - thresholds[conflict.nextThreshold], event.key, conflict.version});
+                conflict.nextThreshold++;
+            }
+        }
+        return due;
+    }
+
+    size_t size()
+    {
+        lock_guard<mutex> lock(calendarMutex);
+        return conflicts.size();
+    }
+
+private:
+    static constexpr double SAME_CONFLICT_TOLERANCE = 0.01; // Predictions closer than this, in seconds, are the same conflict.
+
+    struct Conflict
+    {
+        int firstID;
+        int secondID;
+        uint32_t firstEpoch;
+        uint32_t secondEpoch;
+        double conflictTime;  // Predicted time of the loss of separation.
+        uint64_t version;     // Identifies the events of the current prediction.
+        uint64_t lastScan;    // Last scan that confirmed the prediction.
+        size_t nextThreshold; // Index of the next warning threshold to schedule.
+        time_t firstSeen;     // Time at which the conflict was first predicted.
+    };
+
+    struct Event
+    {
+        double time; // Time at which the alert is due.
+        uint64_t key;
+        uint64_t version;
+
+        bool operator<(const Event &other) const
+        {
+            return time > other.time; // Earliest event at the top of the heap.
+        }
+    };
+
+    static uint64_t pairKey(int idA, int idB)
+    {
+        return (uint64_t(uint32_t(min(idA, idB))) << 32) | uint32_t(max(idA, idB));
+    }
+
+    // Removes the events of cancelled or replaced predictions from the top of the heap.
+    void dropObsoleteEvents()
+    {
+        while (!events.empty())
+        {
+            auto found = conflicts.find(events.top().key);
+            if (found != conflicts.end() && found->second.version == events.top().version)
+            {
+                return;
+            }
+            events.pop();
+        }
+    }
+
+    const SimClock &clock;
+    vector<double> thresholds;
+    mutex calendarMutex;
+    condition_variable wakeUp;                   // Signals the waiting thread that an earlier event was added.
+    priority_queue<Event> events;                // Min-heap of events by due time.
+    unordered_map<uint64_t, Conflict> conflicts; // Current prediction of every pair, by pair of aircraft IDs.
+    uint64_t nextVersion;
+    uint64_t scan;
+};
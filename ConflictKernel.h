@@ -0,0 +1,256 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "Aircraft.h"
+
+#ifdef __AVX2__
+#include <immintrin.h> // Used for the 4-wide double precision kernel.
+#endif
+
+using namespace std;
+
+/*NOTE: The conflict kernel solves the same equations as the scalar collision check it replaced, kept as
+    the reference in ConflictKernelTest.cpp, with the same operations in the same order, so both produce
+    bit-identical first alert times. The tracks are read from a structure of arrays
+    so that one aircraft can be tested against 4 others at once when AVX2 is available.
+    When FMA is also enabled, build with -ffp-contract=off to keep the results bit-identical.
+
+    The kernel first computes the roots of the equations, then picks the first alert time from them.
+    Aircrafts fly in straight lines, so the roots stay valid until one of the two aircrafts changes
+    its speed: the first alert time at a later time is picked from the same roots, shifted by the
+    elapsed time. */
+
+// Structure of arrays holding the position and speed of every track.
+struct TrackTable
+{
+    vector<double> x, y, z;
+    vector<double> vx, vy, vz;
+
+    void load(vector<Aircraft> &aircrafts)
+    {
+        size_t n = aircrafts.size();
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        vx.resize(n);
+        vy.resize(n);
+        vz.resize(n);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = aircrafts[i].getPositionX();
+            y[i] = aircrafts[i].getPositionY();
+            z[i] = aircrafts[i].getPositionZ();
+            vx[i] = aircrafts[i].getSpeedX();
+            vy[i] = aircrafts[i].getSpeedY();
+            vz[i] = aircrafts[i].getSpeedZ();
+        }
+    }
+
+    size_t size() const
+    {
+        return x.size();
+    }
+};
+
+// Roots of the horizontal and vertical threshold equations of a pair, relative to the time of the positions.
+struct CollisionRoots
+{
+    double horizontalFirst;  // Smallest time at which the horizontal distance equals the threshold.
+    double horizontalSecond; // Largest time at which the horizontal distance equals the threshold.
+    double verticalFirst;    // Smallest time at which the vertical distance equals the threshold.
+    double verticalSecond;   // Largest time at which the vertical distance equals the threshold.
+    bool horizontalValid;    // False when the horizontal distance never equals the threshold, or never changes.
+    bool level;              // True when the vertical distance never changes.
+    bool levelValid;         // True when the vertical distance never changes and is within the threshold.
+};
+
+// First alert time picked from the roots, "elapsed" seconds after the time of the positions, or -1 if no collision is predicted inside the look-ahead window.
+inline double firstAlertFromRoots(const CollisionRoots &roots, double elapsed, double maxTime)
+{
+    // With no relative horizontal motion the horizontal time stays infinite, which is never inside the window.
+    if (!roots.horizontalValid)
+        return -1.0;
+
+    double t1 = roots.horizontalFirst - elapsed;
+    double t2 = roots.horizontalSecond - elapsed;
+    double t_h_first;
+    if (t1 >= 0)
+        t_h_first = t1;
+    else if (t2 >= 0)
+        t_h_first = t2;
+    else
+        return -1.0;
+
+    double t_v_first;
+    if (roots.level)
+    {
+        if (!roots.levelValid)
+            return -1.0;
+        t_v_first = 0;
+    }
+    else
+    {
+        double v1 = roots.verticalFirst - elapsed;
+        double v2 = roots.verticalSecond - elapsed;
+        if (v1 >= 0)
+            t_v_first = v1;
+        else if (v2 >= 0)
+            t_v_first = v2;
+        else
+            return -1.0;
+    }
+
+    double t_first_alert = max(t_h_first, t_v_first);
+    return (t_first_alert <= maxTime) ? t_first_alert : -1.0;
+}
+
+// Roots of the threshold equations between tracks i and j.
+inline CollisionRoots collisionRoots(const TrackTable &t, int i, int j, double horizontalThreshold, double verticalThreshold)
+{
+    CollisionRoots roots;
+
+    double dx0 = t.x[i] - t.x[j];
+    double dy0 = t.y[i] - t.y[j];
+    double dz0 = t.z[i] - t.z[j];
+    double dvx = t.vx[i] - t.vx[j];
+    double dvy = t.vy[i] - t.vy[j];
+    double dvz = t.vz[i] - t.vz[j];
+
+    double A = dvx * dvx + dvy * dvy;
+    double B = 2 * (dx0 * dvx + dy0 * dvy);
+    double C = dx0 * dx0 + dy0 * dy0;
+
+    // Horizontal: times at which the horizontal distance equals the threshold.
+    C -= horizontalThreshold * horizontalThreshold;
+    double discriminant = B * B - 4 * A * C;
+    roots.horizontalValid = (A != 0) && (discriminant >= 0);
+    if (roots.horizontalValid)
+    {
+        double sqrtD = sqrt(discriminant);
+        roots.horizontalFirst = (-B - sqrtD) / (2 * A);
+        roots.horizontalSecond = (-B + sqrtD) / (2 * A);
+    }
+    else
+    {
+        roots.horizontalFirst = -1.0;
+        roots.horizontalSecond = -1.0;
+    }
+
+    // Vertical: times at which the vertical distance equals the threshold.
+    roots.level = (dvz == 0);
+    roots.levelValid = roots.level && (abs(dz0) <= verticalThreshold);
+    if (roots.level)
+    {
+        roots.verticalFirst = 0;
+        roots.verticalSecond = 0;
+    }
+    else
+    {
+        double v1 = (verticalThreshold - dz0) / dvz;
+        double v2 = (-verticalThreshold - dz0) / dvz;
+        if (v1 > v2)
+            swap(v1, v2);
+        roots.verticalFirst = v1;
+        roots.verticalSecond = v2;
+    }
+
+    return roots;
+}
+
+#ifdef __AVX2__
+// Loads the 4 values at the given indices. The masked gather is given a zero source, the plain one leaves it undefined.
+inline __m256d gather4(const vector<double> &values, __m128i index)
+{
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), values.data(), index, all, 8);
+}
+
+// Computes the roots of track i against the 4 tracks in "others" at once.
+inline void collisionRoots4(const TrackTable &t, int i, const int *others, double horizontalThreshold, double verticalThreshold, CollisionRoots *roots)
+{
+    const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i *>(others));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d rh = _mm256_set1_pd(horizontalThreshold);
+    const __m256d rv = _mm256_set1_pd(verticalThreshold);
+
+    __m256d dx0 = _mm256_sub_pd(_mm256_set1_pd(t.x[i]), gather4(t.x, index));
+    __m256d dy0 = _mm256_sub_pd(_mm256_set1_pd(t.y[i]), gather4(t.y, index));
+    __m256d dz0 = _mm256_sub_pd(_mm256_set1_pd(t.z[i]), gather4(t.z, index));
+    __m256d dvx = _mm256_sub_pd(_mm256_set1_pd(t.vx[i]), gather4(t.vx, index));
+    __m256d dvy = _mm256_sub_pd(_mm256_set1_pd(t.vy[i]), gather4(t.vy, index));
+    __m256d dvz = _mm256_sub_pd(_mm256_set1_pd(t.vz[i]), gather4(t.vz, index));
+
+    __m256d A = _mm256_add_pd(_mm256_mul_pd(dvx, dvx), _mm256_mul_pd(dvy, dvy));
+    __m256d B = _mm256_mul_pd(two, _mm256_add_pd(_mm256_mul_pd(dx0, dvx), _mm256_mul_pd(dy0, dvy)));
+    __m256d C = _mm256_add_pd(_mm256_mul_pd(dx0, dx0), _mm256_mul_pd(dy0, dy0));
+
+    // Horizontal
+    C = _mm256_sub_pd(C, _mm256_mul_pd(rh, rh));
+    __m256d discriminant = _mm256_sub_pd(_mm256_mul_pd(B, B), _mm256_mul_pd(_mm256_mul_pd(four, A), C));
+    __m256d sqrtD = _mm256_sqrt_pd(discriminant);
+    __m256d negB = _mm256_xor_pd(B, signMask);
+    __m256d twoA = _mm256_mul_pd(two, A);
+    __m256d t1 = _mm256_div_pd(_mm256_sub_pd(negB, sqrtD), twoA);
+    __m256d t2 = _mm256_div_pd(_mm256_add_pd(negB, sqrtD), twoA);
+    __m256d hValid = _mm256_and_pd(_mm256_cmp_pd(A, zero, _CMP_NEQ_OQ), _mm256_cmp_pd(discriminant, zero, _CMP_GE_OQ));
+
+    // Vertical
+    __m256d v1 = _mm256_div_pd(_mm256_sub_pd(rv, dz0), dvz);
+    __m256d v2 = _mm256_div_pd(_mm256_sub_pd(_mm256_xor_pd(rv, signMask), dz0), dvz);
+    __m256d swapped = _mm256_cmp_pd(v1, v2, _CMP_GT_OQ);
+    __m256d vLow = _mm256_blendv_pd(v1, v2, swapped);
+    __m256d vHigh = _mm256_blendv_pd(v2, v1, swapped);
+    __m256d level = _mm256_cmp_pd(dvz, zero, _CMP_EQ_OQ);
+    __m256d levelValid = _mm256_and_pd(level, _mm256_cmp_pd(_mm256_andnot_pd(signMask, dz0), rv, _CMP_LE_OQ));
+
+    double h1[4], h2[4], low[4], high[4];
+    _mm256_storeu_pd(h1, t1);
+    _mm256_storeu_pd(h2, t2);
+    _mm256_storeu_pd(low, vLow);
+    _mm256_storeu_pd(high, vHigh);
+    int hMask = _mm256_movemask_pd(hValid);
+    int levelMask = _mm256_movemask_pd(level);
+    int levelValidMask = _mm256_movemask_pd(levelValid);
+
+    for (int k = 0; k < 4; k++)
+    {
+        CollisionRoots &r = roots[k];
+        r.horizontalValid = (hMask >> k) & 1;
+        r.horizontalFirst = r.horizontalValid ? h1[k] : -1.0;
+        r.horizontalSecond = r.horizontalValid ? h2[k] : -1.0;
+        r.level = (levelMask >> k) & 1;
+        r.levelValid = (levelValidMask >> k) & 1;
+        r.verticalFirst = r.level ? 0 : low[k];
+        r.verticalSecond = r.level ? 0 : high[k];
+    }
+}
+#endif
+
+// Computes the roots of track i against every track in others[0..count).
+inline void collisionRootsBatch(const TrackTable &t, int i, const int *others, size_t count, double horizontalThreshold, double verticalThreshold, CollisionRoots *roots)
+{
+    size_t k = 0;
+#ifdef __AVX2__
+    for (; k + 4 <= count; k += 4)
+    {
+        collisionRoots4(t, i, others + k, horizontalThreshold, verticalThreshold, roots + k);
+    }
+#endif
+    for (; k < count; k++)
+    {
+        roots[k] = collisionRoots(t, i, others[k], horizontalThreshold, verticalThreshold);
+    }
+}
+
+// First alert time between tracks i and j, or -1 if no collision is predicted inside the look-ahead window.
+inline double collisionFirstAlert(const TrackTable &t, int i, int j, double maxTime, double horizontalThreshold, double verticalThreshold)
+{
+    return firstAlertFromRoots(collisionRoots(t, i, j, horizontalThreshold, verticalThreshold), 0, maxTime);
+}
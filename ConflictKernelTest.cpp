@@ -0,0 +1,354 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "ConflictKernel.h"
+#include "Random.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: Checks that the conflict kernel gives bit-identical first alert times to the scalar collision check
+    it replaced, kept below as the reference, then measures the pairs per second of both. Pairs of level,
+    parallel, diverging and random aircrafts are tested in batches of every size, so the 4-wide AVX2 path
+    and the scalar tail are both covered. Build it twice to check both paths of the kernel:
+        g++ -std=c++17 -O2 ConflictKernelTest.cpp
+        g++ -std=c++17 -O2 -mavx2 -ffp-contract=off ConflictKernelTest.cpp
+
+    Usage: ConflictKernelTest [--seed N] [--pairs N] [--rounds N]
+        --pairs is the number of pairs tested in every case, and timed by the benchmark.
+        --rounds is the number of times the benchmark is run, the fastest one is printed. */
+
+// Thresholds and look-ahead window, the same as the Computer's
+const double HORIZONTAL_SEPARATION = 3000.0;
+const double VERTICAL_SEPARATION = 1000.0;
+const double COLLISION_LOOKAHEAD = 120.0;
+
+const int MAX_BATCH = 37; // Largest batch of pairs given to the kernel at once, not a multiple of 4
+
+// Uniform double in [low, high).
+double uniformReal(Random &random, double low, double high)
+{
+    return low + random.unit() * (high - low);
+}
+
+// The scalar collision check of the Computer, which the kernel replaced. This and the subsequent methods are
+// the reference the kernel must match bit for bit.
+bool solveQuadraticFirstTime(double A, double B, double C, double R, double &t_first)
+{
+    C -= R * R;
+
+    double discriminant = B * B - 4 * A * C;
+    if (discriminant < 0)
+        return false;
+
+    double sqrtD = sqrt(discriminant);
+    double t1 = (-B - sqrtD) / (2 * A);
+    double t2 = (-B + sqrtD) / (2 * A);
+
+    if (t1 >= 0)
+        t_first = t1;
+    else if (t2 >= 0)
+        t_first = t2;
+    else
+        return false;
+
+    return true;
+}
+
+bool solveLinearFirstTime(double dz0, double dvz, double R, double &t_first)
+{
+    if (dvz == 0)
+    {
+        if (abs(dz0) <= R)
+        {
+            t_first = 0;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    double t1 = (R - dz0) / dvz;
+    double t2 = (-R - dz0) / dvz;
+
+    if (t1 > t2)
+        swap(t1, t2);
+
+    if (t1 >= 0)
+        t_first = t1;
+    else if (t2 >= 0)
+        t_first = t2;
+    else
+        return false;
+
+    return true;
+}
+
+tuple<bool, double> collisionCheck(Aircraft *a1, Aircraft *a2)
+{
+    const double maxTime = COLLISION_LOOKAHEAD;
+    const double horizontalThreshold = HORIZONTAL_SEPARATION;
+    const double verticalThreshold = VERTICAL_SEPARATION;
+
+    double dx0 = a1->getPositionX() - a2->getPositionX();
+    double dy0 = a1->getPositionY() - a2->getPositionY();
+    double dz0 = a1->getPositionZ() - a2->getPositionZ();
+    double dvx = a1->getSpeedX() - a2->getSpeedX();
+    double dvy = a1->getSpeedY() - a2->getSpeedY();
+    double dvz = a1->getSpeedZ() - a2->getSpeedZ();
+
+    double A = dvx * dvx + dvy * dvy;
+    double B = 2 * (dx0 * dvx + dy0 * dvy);
+    double C = dx0 * dx0 + dy0 * dy0;
+
+    double t_h_first = numeric_limits<double>::infinity();
+    double t_v_first = numeric_limits<double>::infinity();
+
+    bool horizontalValid = (A == 0) ? (sqrt(C) <= horizontalThreshold) : solveQuadraticFirstTime(A, B, C, horizontalThreshold, t_h_first);
+    bool verticalValid = solveLinearFirstTime(dz0, dvz, verticalThreshold, t_v_first);
+
+    if (!horizontalValid || !verticalValid)
+    {
+        return make_tuple(false, -1.0);
+    }
+
+    double t_first_alert = max(t_h_first, t_v_first);
+
+    if (t_first_alert <= maxTime)
+    {
+        return make_tuple(true, t_first_alert);
+    }
+
+    return make_tuple(false, -1.0);
+}
+
+enum PairCase
+{
+    CASE_LEVEL,     // Same vertical speed
+    CASE_PARALLEL,  // Same horizontal speed
+    CASE_DIVERGING, // Flying away from each other
+    CASE_RANDOM,
+    CASE_COUNT
+};
+
+const char *CASE_NAMES[CASE_COUNT] = {"level", "parallel", "diverging", "random"};
+
+Aircraft randomAircraft(Random &random, double x, double y, double z)
+{
+    return Aircraft(0, 0, x, y, z, uniformReal(random, -900, 900), uniformReal(random, -900, 900), uniformReal(random, -50, 50), false);
+}
+
+// Aircraft paired with "first" in the given case, within a few separation minima of it.
+Aircraft pairedAircraft(Random &random, Aircraft &first, PairCase pairCase)
+{
+    // Whole numbers, like the hand-written scenarios, half of the time, so the thresholds are hit exactly.
+    bool whole = random.next() & 1;
+    auto offset = [&](double range)
+    {
+        return whole ? double(random.uniform(-int64_t(range), int64_t(range))) : uniformReal(random, -range, range);
+    };
+
+    Aircraft second = randomAircraft(random, first.getPositionX() + offset(4 * HORIZONTAL_SEPARATION),
+                                      first.getPositionY() + offset(4 * HORIZONTAL_SEPARATION),
+                                      first.getPositionZ() + offset(4 * VERTICAL_SEPARATION));
+    if (whole)
+    {
+        second.setSpeedX(round(second.getSpeedX()));
+        second.setSpeedY(round(second.getSpeedY()));
+        second.setSpeedZ(round(second.getSpeedZ()));
+    }
+
+    switch (pairCase)
+    {
+    case CASE_LEVEL:
+        second.setSpeedZ(first.getSpeedZ());
+        break;
+    case CASE_PARALLEL:
+        second.setSpeedX(first.getSpeedX());
+        second.setSpeedY(first.getSpeedY());
+        break;
+    case CASE_DIVERGING:
+    {
+        // The relative speed points away from the first aircraft on every axis.
+        double dx = second.getPositionX() - first.getPositionX();
+        double dy = second.getPositionY() - first.getPositionY();
+        double dz = second.getPositionZ() - first.getPositionZ();
+        second.setSpeedX(first.getSpeedX() + copysign(abs(second.getSpeedX() - first.getSpeedX()), dx));
+        second.setSpeedY(first.getSpeedY() + copysign(abs(second.getSpeedY() - first.getSpeedY()), dy));
+        second.setSpeedZ(first.getSpeedZ() + copysign(abs(second.getSpeedZ() - first.getSpeedZ()), dz));
+        break;
+    }
+    default:
+        break;
+    }
+    return second;
+}
+
+// Aircrafts of a case: aircraft 0, then the aircrafts paired with it.
+vector<Aircraft> makeCase(Random &random, PairCase pairCase, size_t pairs)
+{
+    vector<Aircraft> aircrafts;
+    aircrafts.push_back(randomAircraft(random, 50000, 50000, 20000));
+    for (size_t k = 0; k < pairs; k++)
+    {
+        aircrafts.push_back(pairedAircraft(random, aircrafts[0], pairCase));
+    }
+    return aircrafts;
+}
+
+// Compares the kernel with the reference on every pair of a case, in batches of varying size. Returns the number of mismatches.
+size_t checkCase(Random &random, vector<Aircraft> &aircrafts, size_t &alerts)
+{
+    TrackTable tracks;
+    tracks.load(aircrafts);
+
+    vector<int> others;
+    vector<CollisionRoots> roots;
+    size_t mismatches = 0;
+    for (size_t begin = 1; begin < aircrafts.size();)
+    {
+        size_t count = min(size_t(random.uniform(1, MAX_BATCH)), aircrafts.size() - begin);
+        others.clear();
+        for (size_t k = 0; k < count; k++)
+        {
+            others.push_back(int(begin + k));
+        }
+        roots.resize(count);
+        collisionRootsBatch(tracks, 0, others.data(), count, HORIZONTAL_SEPARATION, VERTICAL_SEPARATION, roots.data());
+
+        for (size_t k = 0; k < count; k++)
+        {
+            auto [collision, expected] = collisionCheck(&aircrafts[0], &aircrafts[others[k]]);
+            double found = firstAlertFromRoots(roots[k], 0, COLLISION_LOOKAHEAD);
+            alerts += collision ? 1 : 0;
+            if ((found >= 0) != collision || memcmp(&found, &expected, sizeof(double)) != 0)
+            {
+                if (mismatches++ < 5)
+                {
+                    cerr << setprecision(17) << "  pair " << others[k] << ": expected " << expected << ", kernel gave " << found << endl;
+                }
+            }
+        }
+        begin += count;
+    }
+    return mismatches;
+}
+
+// Fastest time of the given number of runs, in seconds.
+template <typename Run>
+double fastestRun(int rounds, Run run)
+{
+    double best = numeric_limits<double>::infinity();
+    for (int round = 0; round < rounds; round++)
+    {
+        steady_clock::time_point start = steady_clock::now();
+        run();
+        best = min(best, duration<double>(steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = 1;
+    size_t pairs = 1000000;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (option == "--seed" && hasValue)
+        {
+            seed = stoull(argv[++i]);
+        }
+        else if (option == "--pairs" && hasValue)
+        {
+            pairs = stoull(argv[++i]);
+        }
+        else if (option == "--rounds" && hasValue)
+        {
+            rounds = stoi(argv[++i]);
+        }
+        else
+        {
+            cerr << "Unknown option: " << option << endl;
+            return 1;
+        }
+    }
+    if (pairs == 0 || rounds <= 0)
+    {
+        cerr << "--pairs and --rounds must be positive" << endl;
+        return 1;
+    }
+
+#ifdef __AVX2__
+    cout << "Conflict kernel built with AVX2" << endl;
+#else
+    cout << "Conflict kernel built without AVX2" << endl;
+#endif
+
+    Random random(seed);
+    size_t failures = 0;
+    for (int pairCase = 0; pairCase < CASE_COUNT; pairCase++)
+    {
+        vector<Aircraft> aircrafts = makeCase(random, PairCase(pairCase), pairs);
+        size_t alerts = 0;
+        size_t mismatches = checkCase(random, aircrafts, alerts);
+        cout << setw(10) << left << CASE_NAMES[pairCase] << right << setw(10) << pairs << " pairs, " << setw(8) << alerts << " alerts, "
+             << mismatches << " mismatches" << endl;
+        failures += mismatches;
+    }
+
+    // Throughput on the random pairs, the kernel is given the pairs of aircraft 0 in batches of MAX_BATCH like the Computer would.
+    vector<Aircraft> aircrafts = makeCase(random, CASE_RANDOM, pairs);
+    TrackTable tracks;
+    tracks.load(aircrafts);
+    vector<int> others(pairs);
+    for (size_t k = 0; k < pairs; k++)
+    {
+        others[k] = int(k + 1);
+    }
+    vector<CollisionRoots> roots(pairs);
+    size_t referenceAlerts = 0, kernelAlerts = 0;
+
+    double referenceTime = fastestRun(rounds, [&]
+                                      {
+        referenceAlerts = 0;
+        for (size_t k = 1; k <= pairs; k++)
+        {
+            referenceAlerts += get<0>(collisionCheck(&aircrafts[0], &aircrafts[k])) ? 1 : 0;
+        } });
+    double kernelTime = fastestRun(rounds, [&]
+                                   {
+        kernelAlerts = 0;
+        for (size_t begin = 0; begin < pairs; begin += MAX_BATCH)
+        {
+            size_t count = min(size_t(MAX_BATCH), pairs - begin);
+            collisionRootsBatch(tracks, 0, others.data() + begin, count, HORIZONTAL_SEPARATION, VERTICAL_SEPARATION, roots.data() + begin);
+        }
+        for (size_t k = 0; k < pairs; k++)
+        {
+            kernelAlerts += firstAlertFromRoots(roots[k], 0, COLLISION_LOOKAHEAD) >= 0 ? 1 : 0;
+        } });
+
+    cout << fixed << setprecision(1)
+         << "Reference: " << pairs / referenceTime / 1e6 << " million pairs/s" << endl
+         << "Kernel:    " << pairs / kernelTime / 1e6 << " million pairs/s (" << referenceTime / kernelTime << "x)" << endl;
+    if (referenceAlerts != kernelAlerts)
+    {
+        cerr << "The benchmark found " << referenceAlerts << " alerts with the reference and " << kernelAlerts << " with the kernel" << endl;
+        failures++;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
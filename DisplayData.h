@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*NOTE: Layouts of the shared memory written by the Computer and read by the Visual Display.
+    Both subsystems include this file, so the records are never converted to text in between;
+    the Visual Display formats them only when it prints them. */
+
+// Alerts ("/AlertsData")
+// The alerts are a ring of records. Every alert gets the next sequence number, and is stored in the
+// slot "sequence % capacity", so the Visual Display only prints the alerts it has not seen yet.
+const uint32_t ALERTS_MAGIC = 0x54524C41; // "ALRT"
+const uint32_t ALERTS_VERSION = 1;
+const uint32_t ALERT_CAPACITY = 256; // Number of alerts kept in the ring.
+
+enum AlertKind : uint8_t
+{
+    ALERT_SEPARATION_VIOLATION = 1, // Two aircrafts are closer than the separation minima.
+    ALERT_PREDICTED_COLLISION = 2,  // Two aircrafts will be closer than the separation minima.
+};
+
+struct Alert
+{
+    uint64_t sequence;    // Position of the alert in the stream of alerts, starting at 1.
+    int64_t firstSeen;    // Time at which the conflict was first detected, in seconds since the epoch.
+    int32_t firstID;      // Aircraft with the smallest ID.
+    int32_t secondID;     // Aircraft with the largest ID.
+    float timeToConflict; // Seconds left before the loss of separation, 0 for a violation.
+    uint8_t kind;         // One of AlertKind.
+
+    bool operator<(const Alert &other) const
+    {
+        return timeToConflict > other.timeToConflict; // Higher priority for more imminent alerts
+    }
+};
+
+struct AlertsHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t reserved;
+    uint64_t sequence; // Sequence number of the last alert written.
+};
+
+const size_t ALERTS_SHM_SIZE = sizeof(AlertsHeader) + ALERT_CAPACITY * sizeof(Alert);
+
+inline Alert *alertRecords(void *segment)
+{
+    return reinterpret_cast<Alert *>(static_cast<char *>(segment) + sizeof(AlertsHeader));
+}
+
+// Aircrafts ("/AircraftData")
+// The Computer publishes the tracks as a stream of changes: a ring of deltas, every one with the next
+// sequence number, and a keyframe holding every track, written every few publications. The Visual
+// Display keeps its own copy of the tracks and applies the deltas it has not seen yet, so its work is
+// proportional to what changed. When it falls so far behind that the ring has overwritten deltas it
+// needs, or starts, it copies the keyframe and applies the deltas that follow it.
+//
+// The keyframe is consistent with the deltas up to "keyframeSequence". When the Computer cannot
+// describe a publication with deltas, it only writes a keyframe and skips the sequence forward by more
+// than the ring holds, so every reader that was not up to date copies the keyframe.
+//
+// The Computer sizes the segment from its configured capacity, so the Visual Display reads the header
+// before mapping the whole segment.
+const uint32_t TRACKS_MAGIC = 0x534B5254; // "TRKS"
+const uint32_t TRACKS_VERSION = 2;
+const uint32_t TRACK_DELTAS_PER_TRACK = 4; // Deltas in the ring for every track record of the keyframe.
+
+struct TracksHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;         // Number of track records the keyframe can hold.
+    uint32_t count;            // Number of valid track records in the keyframe.
+    uint64_t generation;       // Incremented every time the Computer publishes the tracks.
+    uint32_t deltaCapacity;    // Number of deltas in the ring.
+    uint32_t reserved;
+    uint64_t keyframeSequence; // Sequence of the last delta included in the keyframe.
+    uint64_t deltaSequence;    // Sequence of the last delta written, the first one is 1.
+};
+
+struct TrackRecord
+{
+    double positionX, positionY, positionZ;
+    int32_t aircraftID;
+    uint8_t isViolation; // 1 when the aircraft is in violation, or predicted to be.
+    uint8_t reserved[3];
+};
+
+enum TrackDeltaKind : uint8_t
+{
+    TRACK_UPDATED = 1, // The track is new, or has moved or changed.
+    TRACK_REMOVED = 2, // The aircraft has left the airspace, only the ID of the track is set.
+};
+
+struct TrackDelta
+{
+    uint64_t sequence; // Stored in the slot "sequence % deltaCapacity".
+    TrackRecord track;
+    uint8_t kind; // One of TrackDeltaKind.
+    uint8_t reserved[7];
+};
+
+inline size_t tracksSegmentSize(uint32_t capacity)
+{
+    return sizeof(TracksHeader) + size_t(capacity) * sizeof(TrackRecord) + size_t(capacity) * TRACK_DELTAS_PER_TRACK * sizeof(TrackDelta);
+}
+
+inline TrackRecord *trackRecords(void *segment)
+{
+    return reinterpret_cast<TrackRecord *>(static_cast<char *>(segment) + sizeof(TracksHeader));
+}
+
+inline TrackDelta *trackDeltas(void *segment)
+{
+    uint32_t capacity = static_cast<TracksHeader *>(segment)->capacity;
+    return reinterpret_cast<TrackDelta *>(static_cast<char *>(segment) + sizeof(TracksHeader) + size_t(capacity) * sizeof(TrackRecord));
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <semaphore.h>
+
+using namespace std;
+
+/*NOTE: A doorbell wakes the next subsystem on the path of a command (Operator -> Computer -> Communication
+    -> Radar) as soon as the command is written, instead of leaving it in shared memory until the next
+    poll. A doorbell is a named semaphore that starts at 0: the sender posts it after writing, and the
+    receiver waits on it with a timeout, so it still checks for termination while no command comes.
+
+    Every command carries the CLOCK_MONOTONIC time at which it left the previous subsystem, the same clock
+    in every process, so each hop measures how long the command took to reach it (see HopLatency). */
+
+const char *OPERATOR_DOORBELL = "/operator_doorbell";           // Operator -> Computer
+const char *COMMUNICATION_DOORBELL = "/communication_doorbell"; // Computer -> Communication
+const char *RADAR_DOORBELL = "/radar_doorbell";                 // Communication -> Radar
+
+// Nanoseconds on CLOCK_MONOTONIC, comparable between processes.
+inline uint64_t monotonicNanoseconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return uint64_t(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+class Doorbell
+{
+public:
+    // Constructor, exits if the semaphore cannot be opened
+    Doorbell(const char *name) : name(name)
+    {
+        semaphore = sem_open(name, O_CREAT, 0666, 0);
+        if (semaphore == SEM_FAILED)
+        {
+            perror(("sem_open() for " + string(name) + " failed").c_str());
+            exit(1);
+        }
+    }
+
+    // Destructor
+    ~Doorbell()
+    {
+        sem_close(semaphore);
+    }
+
+    // Called by the sender once the command is in shared memory.
+    void ring()
+    {
+        sem_post(semaphore);
+    }
+
+    // Waits until the doorbell rings or the timeout expires, returns false on timeout. The rings that came
+    // in meanwhile are taken too, since the receiver handles every pending command once it is awake.
+    bool wait(double timeoutSeconds)
+    {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline); // sem_timedwait() only takes a deadline on the real-time clock
+        long nanoseconds = long(timeoutSeconds * 1e9);
+        deadline.tv_sec += nanoseconds / 1000000000L;
+        deadline.tv_nsec += nanoseconds % 1000000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+
+        int result;
+        while ((result = sem_timedwait(semaphore, &deadline)) == -1 && errno == EINTR)
+            ;
+        if (result == -1)
+        {
+            if (errno != ETIMEDOUT)
+            {
+                perror(("sem_timedwait() for " + string(name) + " failed").c_str());
+            }
+            return false;
+        }
+
+        while (sem_trywait(semaphore) == 0)
+            ;
+        return true;
+    }
+
+private:
+    const char *name;
+    sem_t *semaphore;
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SharedState.h"
+
+using namespace std;
+
+/*NOTE: Layout of the metrics page ("/atc_metrics"), written by every subsystem and read by AtcStat.
+    The page holds a fixed list of counters and gauges, one per cache line. A counter only grows, so a
+    reader turns two readings into a rate; a gauge holds the current value of something, such as the
+    number of tracks. Every value is written with a single relaxed atomic operation, without a lock,
+    and each one has a single subsystem writing it.
+
+    Whichever subsystem starts first creates the page. A subsystem that cannot map it, or finds a page
+    of another layout, writes to a private page instead, so the call sites never have to check. */
+
+const char *METRICS_NAME = "/atc_metrics";
+const uint32_t METRICS_MAGIC = 0x5352544D;        // "MTRS"
+const uint32_t METRICS_INITIALIZING = 0x54494E49; // "INIT", while the first subsystem fills in the header
+const uint32_t METRICS_VERSION = 1;
+
+enum MetricKind : uint8_t
+{
+    METRIC_COUNTER = 1, // Printed as a rate per second.
+    METRIC_GAUGE = 2,   // Printed as is.
+};
+
+enum MetricId : uint32_t
+{
+    RADAR_STEPS,
+    RADAR_LATE_STEPS,
+    RADAR_AIRCRAFTS,
+    RADAR_SPEED_CHANGES,
+    COMPUTER_TRACKS,
+    COMPUTER_RADAR_UPDATES,
+    COMPUTER_SEPARATION_PAIRS,
+    COMPUTER_COLLISION_PAIRS,
+    COMPUTER_ALERTS,
+    COMPUTER_COMMANDS,
+    COMPUTER_BYTES_WRITTEN,
+    COMPUTER_SEMAPHORE_WAIT,
+    COMMUNICATION_COMMANDS,
+    COMMUNICATION_DROPPED,
+    OPERATOR_COMMANDS,
+    OPERATOR_RING_FULL,
+    DISPLAY_REFRESHES,
+    DISPLAY_TRACK_UPDATES,
+    DISPLAY_RESYNCS,
+    DISPLAY_SEMAPHORE_WAIT,
+    METRIC_COUNT
+};
+
+struct MetricDescription
+{
+    const char *subsystem;
+    const char *column; // Short name printed by AtcStat.
+    MetricKind kind;
+    double scale; // The value is divided by it before being printed.
+    const char *description;
+};
+
+const MetricDescription METRIC_DESCRIPTIONS[METRIC_COUNT] = {
+    {"radar", "steps", METRIC_COUNTER, 1, "Simulation steps"},
+    {"radar", "late", METRIC_COUNTER, 1, "Steps that started more than a step late"},
+    {"radar", "acft", METRIC_GAUGE, 1, "Aircrafts in the airspace"},
+    {"radar", "spd", METRIC_COUNTER, 1, "Speed changes applied"},
+    {"computer", "trk", METRIC_GAUGE, 1, "Tracks"},
+    {"computer", "upd", METRIC_COUNTER, 1, "Updates of the tracks from the radar"},
+    {"computer", "sep", METRIC_COUNTER, 1, "Pairs tested for separation"},
+    {"computer", "col", METRIC_COUNTER, 1, "Pairs tested for collisions"},
+    {"computer", "alrt", METRIC_COUNTER, 1, "Alerts sent to the Visual Display"},
+    {"computer", "cmd", METRIC_COUNTER, 1, "Operator commands processed"},
+    {"computer", "kB", METRIC_COUNTER, 1e3, "Kilobytes of tracks and alerts written for the Visual Display"},
+    {"computer", "semw", METRIC_COUNTER, 1e6, "Milliseconds spent waiting for the Visual Display semaphore"},
+    {"comm", "cmd", METRIC_COUNTER, 1, "Speed changes forwarded to the Radar"},
+    {"comm", "drop", METRIC_COUNTER, 1, "Speed changes dropped"},
+    {"oper", "cmd", METRIC_COUNTER, 1, "Commands sent to the Computer"},
+    {"oper", "full", METRIC_COUNTER, 1, "Commands refused because the ring was full"},
+    {"display", "ref", METRIC_COUNTER, 1, "Refreshes of the airspace"},
+    {"display", "upd", METRIC_COUNTER, 1, "Track updates applied"},
+    {"display", "sync", METRIC_COUNTER, 1, "Copies of the tracks from a keyframe"},
+    {"display", "semw", METRIC_COUNTER, 1e6, "Milliseconds spent waiting for the data semaphore"},
+};
+
+struct alignas(64) MetricValue
+{
+    atomic<uint64_t> value;
+};
+
+struct MetricsPage
+{
+    atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t count; // Number of values, METRIC_COUNT of the subsystem that created the page.
+    uint32_t reserved;
+    MetricValue values[METRIC_COUNT];
+};
+
+// Checks the header of a mapped page.
+inline bool isMetricsPage(const MetricsPage *page)
+{
+    return page->magic.load(memory_order_acquire) == METRICS_MAGIC && page->version == METRICS_VERSION && page->count == METRIC_COUNT;
+}
+
+class Metrics
+{
+public:
+    // Constructor, the values go to a private page until open() is called
+    Metrics() : page(new MetricsPage()) {}
+
+    // Maps the metrics page, creating it if this subsystem is the first one. Called once by main(), before
+    // the threads that write the metrics are started.
+    void open()
+    {
+        int fd = shm_open(METRICS_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd == -1)
+        {
+            perror("shm_open() for the metrics failed, they are not published");
+            return;
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) == -1 || (size_t(status.st_size) < sizeof(MetricsPage) && ftruncate(fd, sizeof(MetricsPage)) == -1))
+        {
+            perror("ftruncate() for the metrics failed, they are not published");
+            close(fd);
+            return;
+        }
+
+        void *shared = mmap(0, sizeof(MetricsPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (shared == MAP_FAILED)
+        {
+            perror("mmap() for the metrics failed, they are not published");
+            return;
+        }
+
+        // The new page is all zeroes, the first subsystem to claim it fills in the header.
+        MetricsPage *sharedPage = static_cast<MetricsPage *>(shared);
+        uint32_t expected = 0;
+        if (sharedPage->magic.compare_exchange_strong(expected, METRICS_INITIALIZING, memory_order_acquire))
+        {
+            sharedPage->version = METRICS_VERSION;
+            sharedPage->count = METRIC_COUNT;
+            sharedPage->magic.store(METRICS_MAGIC, memory_order_release);
+        }
+        for (int attempt = 0; attempt < 1000 && sharedPage->magic.load(memory_order_acquire) == METRICS_INITIALIZING; attempt++)
+        {
+            this_thread::yield();
+        }
+
+        if (!isMetricsPage(sharedPage))
+        {
+            cerr << "The metrics page was created by another version of the system, the metrics are not published." << endl;
+            munmap(shared, sizeof(MetricsPage));
+            return;
+        }
+        page = sharedPage;
+    }
+
+    void add(MetricId id, uint64_t amount = 1)
+    {
+        page->values[id].value.fetch_add(amount, memory_order_relaxed);
+    }
+
+    void set(MetricId id, uint64_t value)
+    {
+        page->values[id].value.store(value, memory_order_relaxed);
+    }
+
+private:
+    MetricsPage *page;
+};
+
+// Metrics of the subsystem.
+Metrics &systemMetrics = makeGlobal<Metrics>();
@@ -9,8 +9,12 @@
 #include <fcntl.h>     // Used to open shared memory.
 #include <sys/mman.h>  // Used to map shared memory to an address space.
 #include <sys/stat.h>  // Used to define file permissions.
+#include <unistd.h>    // Used to resize and close shared memory.
 #include <cstring>
 #include <thread> // For "this_thread::sleep_for()".
+#include "Doorbell.h"
+#include "CommandRing.h"
+#include "Metrics.h" // Used to count the commands sent.
 
 using namespace std;
 
@@ -23,11 +27,13 @@ const char *SEMAPHORE_LOGS = "/logs_semaphore"; // Name for the semaphore used t
 const char *SHARED_MEMORY_TERMINATION = "/shm_term";   // Name for the shared memory used to terminate the system.
 const char *SEMAPHORE_TERMINATION = "/term_semaphore"; // Name for the semaphore used to synchronize all processes for the termination of the RTOS.
 
+Doorbell *commandDoorbell; // Rung once a command is in shared memory, so the Computer handles it right away.
+
 // Function Prototypes
 void insertBanner(string title);
 string getCurrentTimestamp();
-void speedChangeRequest(fstream &f, sem_t *sem_logs, void *ptr_logs);
-void augmentedInformationRequest(fstream &f, sem_t *sem_logs, void *ptr_logs);
+void speedChangeRequest(fstream &f, CommandRing &commands);
+void augmentedInformationRequest(fstream &f, CommandRing &commands);
 bool terminateSystem(fstream &f, void *ptr_logs, int fd_logs, void *ptr_term, int fd_term, sem_t *sem_logs, sem_t *sem_term);
 
 int main()
@@ -44,6 +50,9 @@ int main()
         return -1;
     }
 
+    // Publish the number of commands sent in the metrics page.
+    systemMetrics.open();
+
     // Open the Shared Memory Files that the Operator will write into.
     // Logs
     int shm_fd_logs = shm_open(SHARED_MEMORY_LOGS, O_CREAT | O_RDWR, 0666);
@@ -53,8 +62,8 @@ int main()
         exit(1);
     }
 
-    // Resize the shared memory for the logs.
-    int size_logs = ftruncate(shm_fd_logs, SHM_SIZE);
+    // Resize the shared memory for the logs, which holds the ring of commands read by the Computer.
+    int size_logs = ftruncate(shm_fd_logs, COMMAND_RING_SIZE);
     if (size_logs == -1)
     {
         perror("ftruncate() resizing for logs failed"); // This will print the String argument with the errno value appended.
@@ -62,12 +71,14 @@ int main()
     }
 
     // Mapping the shared memory into the Operator's address space.
-    void *shm_ptr_logs = mmap(0, SHM_SIZE, PROT_WRITE, MAP_SHARED, shm_fd_logs, 0);
+    void *shm_ptr_logs = mmap(0, COMMAND_RING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_logs, 0);
     if (shm_ptr_logs == MAP_FAILED)
     {
         cerr << "Shared Memory Mapping for logs failed..." << endl;
         return -1;
     }
+    CommandRing commands(shm_ptr_logs);
+    commands.initialize();
 
     // Termination
     int shm_fd_term = shm_open(SHARED_MEMORY_TERMINATION, O_CREAT | O_RDWR, 0666);
@@ -108,6 +119,8 @@ int main()
         return -1;
     }
 
+    commandDoorbell = new Doorbell(OPERATOR_DOORBELL);
+
     // The algorithm for this subsystem should run until the operator terminates it.
     while (1)
     {
@@ -141,14 +154,14 @@ int main()
                 {
                 case 1:
                     insertBanner("[1] Speed Change Request");
-                    speedChangeRequest(logs, sem_logs, shm_ptr_logs);
+                    speedChangeRequest(logs, commands);
                     break;
                 case 2:
                     insertBanner("[2] Augmented Information Request");
-                    augmentedInformationRequest(logs, sem_logs, shm_ptr_logs);
+                    augmentedInformationRequest(logs, commands);
                     break;
                 case 3:
-                    returnToMain = true; // Return to the main menu.
+                    returnToMainMenu = true; // Return to the main menu.
                     break;
                 default:
                     cout << "Invalid input. Please enter a number between 1 and 3." << endl;
@@ -203,7 +216,7 @@ string getCurrentTimestamp()
 }
 
 // Request an aircraft to change its speed.
-void speedChangeRequest(fstream &f, sem_t *sem_logs, void *ptr_logs)
+void speedChangeRequest(fstream &f, CommandRing &commands)
 {
     int aircraftID = 0;
     // Have the Operator enter the ID of the desired aircraft.
@@ -238,30 +251,36 @@ void speedChangeRequest(fstream &f, sem_t *sem_logs, void *ptr_logs)
     cin >> newSpeedZ;
 
     // Create the speed change request command to be sent to the Computer
-    string speedChange = "Speed_Change" + " " + to_string(aircraftID) + " " + to_string(newSpeedX) + " " + to_string(newSpeedY) + " " + to_string(newSpeedZ) + "\n";
+    string speedChange = string("Speed_Change") + " " + to_string(aircraftID) + " " + to_string(newSpeedX) + " " + to_string(newSpeedY) + " " + to_string(newSpeedZ);
 
     // Log the speed change request command in "Logs.txt"
-    string speedChangeLog = getCurrentTimestamp() + " " + speedChange;
+    string speedChangeLog = getCurrentTimestamp() + " " + speedChange + "\n";
     f << speedChangeLog;
 
-    // Write the speed change request command into shared memory
-    const char *command = speedChange.c_str();
-    if (speedChange.size() < SHM_SIZE)
+    // Write the speed change request command into the ring, stamped with the time at which it is sent
+    OperatorCommand command = {};
+    command.issuedAt = monotonicNanoseconds();
+    command.kind = COMMAND_SPEED_CHANGE;
+    command.aircraftID = aircraftID;
+    command.speedX = newSpeedX;
+    command.speedY = newSpeedY;
+    command.speedZ = newSpeedZ;
+    if (commands.push(command))
     {
-        sem_wait(sem_logs); // Lock the semaphore to enter the critical section.
-        strncpy((char *)ptr_logs, command, SHM_SIZE);
-        sem_post(sem_logs); // Unlock the semaphore to exit the critical section.
+        commandDoorbell->ring();
+        systemMetrics.add(OPERATOR_COMMANDS);
 
         cout << "The speed change request has been logged..." << endl;
     }
     else
     {
-        cerr << "Error: Log entry exceeds the allotted shared memory space." << endl;
+        cerr << "Error: " << COMMAND_RING_CAPACITY << " commands are waiting for the Computer, the request was not sent." << endl;
+        systemMetrics.add(OPERATOR_RING_FULL);
     }
 }
 
 // Request augmented information about an aircraft.
-void augmentedInformationRequest(fstream &f, sem_t *sem_logs, void *ptr_logs)
+void augmentedInformationRequest(fstream &f, CommandRing &commands)
 {
     int aircraftID = 0;
     // Have the Operator enter the ID of the desired aircraft.
@@ -284,25 +303,28 @@ void augmentedInformationRequest(fstream &f, sem_t *sem_logs, void *ptr_logs)
     }
 
     // Create the augmented information request command
-    string augmentedInformation = "Augmented_Information" + " " + to_string(aircraftID) + "\n";
+    string augmentedInformation = string("Augmented_Information") + " " + to_string(aircraftID);
 
     // Log the augmented information request command in "Logs.txt"
-    string augmentedInformationLog = getCurrentTimestamp() + " " + augmentedInformation;
+    string augmentedInformationLog = getCurrentTimestamp() + " " + augmentedInformation + "\n";
     f << augmentedInformationLog;
 
-    // Write the augmented information request command into shared memory
-    const char *command = augmentedInformation.c_str();
-    if (augmentedInformation.size() < SHM_SIZE)
+    // Write the augmented information request command into the ring, stamped with the time at which it is sent
+    OperatorCommand command = {};
+    command.issuedAt = monotonicNanoseconds();
+    command.kind = COMMAND_AUGMENTED_INFORMATION;
+    command.aircraftID = aircraftID;
+    if (commands.push(command))
     {
-        sem_wait(sem_logs); // Lock the semaphore to enter the critical section.
-        strncpy((char *)ptr_logs, command, SHM_SIZE);
-        sem_post(sem_logs); // Unlock the semaphore to exit the critical section.
+        commandDoorbell->ring();
+        systemMetrics.add(OPERATOR_COMMANDS);
 
         cout << "The augmented information request has been logged..." << endl;
     }
     else
     {
-        cerr << "Error: Log entry exceeds the allotted shared memory space." << endl;
+        cerr << "Error: " << COMMAND_RING_CAPACITY << " commands are waiting for the Computer, the request was not sent." << endl;
+        systemMetrics.add(OPERATOR_RING_FULL);
     }
 }
 
@@ -327,7 +349,7 @@ bool terminateSystem(fstream &f, void *ptr_logs, int fd_logs, void *ptr_term, in
 
             // Clean up the shared memory for the logs.
             // Unmaps the shared memory for the logs.
-            if (munmap(ptr_logs, SHM_SIZE) == -1)
+            if (munmap(ptr_logs, COMMAND_RING_SIZE) == -1)
             {
                 perror("munmap() for logs failed"); // This will print the String argument with the errno value appended.
                 return false;
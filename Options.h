@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/*NOTE: Values of the command-line options. A value that is not a number, has characters after the number,
+    or is outside of its range throws invalid_argument or out_of_range, both logic_error, so main() can
+    print its usage message instead of starting with a value that makes no sense. */
+
+// Whole number in [low, high].
+inline long parseInteger(const string &value, long low, long high)
+{
+    size_t parsed;
+    long number = stol(value, &parsed);
+    if (parsed != value.size())
+    {
+        throw invalid_argument(value);
+    }
+    if (number < low || number > high)
+    {
+        throw out_of_range(value);
+    }
+    return number;
+}
+
+// Finite number in [low, high].
+inline double parseNumber(const string &value, double low, double high)
+{
+    size_t parsed;
+    double number = stod(value, &parsed);
+    if (parsed != value.size())
+    {
+        throw invalid_argument(value);
+    }
+    if (!isfinite(number) || number < low || number > high)
+    {
+        throw out_of_range(value);
+    }
+    return number;
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+#include <pthread.h>
+#include <sched.h>
+#include "SimClock.h"
+#include "AsyncLog.h"
+#include "TaskMetrics.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: The periodic executor runs the periodic tasks of a subsystem on a few worker threads instead of
+    one sleeping thread per task. Every task is released at fixed times on the simulation clock, one
+    period apart from its first release, so a slow run does not shift the following ones. The thread
+    that calls run() keeps the releases in a heap ordered by time and hands every due task to the
+    workers, which take the ready task with the highest priority first. Priorities are rate-monotonic
+    by convention: the shorter the period, the higher the priority.
+
+    A task never runs twice at once. A release that comes while the previous run of the task is still
+    going, or that the clock has already passed by more than a period, is skipped and counted. Every
+    release is stamped with the monotonic clock when it is handed to the workers, and its run is
+    measured from that stamp in real time, so a clock that stops or jumps does not distort it. Every
+    task records its runs in the task metrics of the subsystem: the release jitter, the delay between
+    the stamp and the start of the run, the execution time, and the deadline misses, runs that end
+    after the deadline of the task, converted to real time at the speed of the clock.
+
+    When a real-time priority is given, the workers run under SCHED_FIFO at that priority plus the
+    priority of the task they run. Without the privilege to do so they keep the default policy. */
+
+class PeriodicExecutor
+{
+public:
+    // Constructor, a real-time priority of 0 keeps the workers under the default policy
+    PeriodicExecutor(const SimClock &simulationClock, size_t workers, int realtimePriority = 0)
+        : clock(simulationClock), workerCount(max(workers, size_t(1))), realtimePriority(realtimePriority), stopping(false) {}
+
+    // Registers a task, all times are in seconds of the simulation clock. The deadline is counted from every
+    // release and is at most the period. Must be called before run().
+    void addTask(const string &name, double period, double deadline, int priority, function<void()> body)
+    {
+        Task task;
+        task.name = name;
+        task.period = period;
+        task.deadline = min(deadline, period);
+        task.priority = priority;
+        task.body = move(body);
+        task.metrics = &taskMetrics.add(name);
+        tasks.push_back(move(task));
+    }
+
+    // Releases the tasks until the flag is set, then waits for the runs in progress.
+    // Every task is first released one period after run() is called.
+    void run(const atomic<bool> &terminate)
+    {
+        stopping = false;
+        for (size_t i = 0; i < workerCount; i++)
+        {
+            workers.emplace_back(&PeriodicExecutor::workerLoop, this);
+        }
+
+        double previous = clock.now();
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            releases.push({previous + tasks[i].period, i});
+        }
+
+        while (!terminate && !releases.empty())
+        {
+            double now = clock.now();
+            if (now < previous)
+            {
+                restartReleases(now, previous); // The Radar started driving the clock, which went back to 0.
+            }
+            previous = now;
+
+            while (!releases.empty() && releases.top().time <= now)
+            {
+                Release release = releases.top();
+                releases.pop();
+                releaseTask(release, now);
+            }
+
+            // The wait is bounded so the termination flag and the clock are checked regularly.
+            double next = releases.empty() ? now : releases.top().time;
+            this_thread::sleep_for(min(clock.realDelay(next - now), duration<double>(DISPATCH_POLL)));
+        }
+
+        {
+            lock_guard<mutex> lock(executorMutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+private:
+    struct Task
+    {
+        string name;
+        double period;
+        double deadline;
+        int priority;
+        function<void()> body;
+        bool running = false; // A run is ready or in progress
+        TaskMetrics *metrics;
+    };
+
+    struct Release
+    {
+        double time;
+        size_t task;
+
+        bool operator<(const Release &other) const
+        {
+            return time > other.time; // Earliest release on top
+        }
+    };
+
+    // Release handed to the workers.
+    struct Job
+    {
+        double release;
+        size_t task;
+        int priority;
+        uint64_t dispatched; // Monotonic time at which the release was handed to the workers, in nanoseconds
+
+        bool operator<(const Job &other) const
+        {
+            return priority < other.priority || (priority == other.priority && release > other.release);
+        }
+    };
+
+    static constexpr double DISPATCH_POLL = 0.1; // Longest real wait of the releasing thread.
+
+    void releaseTask(const Release &release, double now)
+    {
+        Task &task = tasks[release.task];
+
+        // The next release keeps the phase of the task. Releases the clock has already passed are dropped,
+        // the clock can move by many periods at once when the Radar runs much faster than real time.
+        double next = release.time + task.period;
+        uint64_t passed = 0;
+        if (next <= now)
+        {
+            passed = uint64_t((now - next) / task.period) + 1;
+            next += passed * task.period;
+        }
+        releases.push({next, release.task});
+
+        {
+            lock_guard<mutex> lock(executorMutex);
+            task.metrics->recordSkipped(passed + (task.running ? 1 : 0));
+            if (task.running)
+            {
+                return;
+            }
+            task.running = true;
+            ready.push({release.time, release.task, task.priority, monotonicNanoseconds()});
+        }
+        jobReady.notify_one();
+    }
+
+    // Releases every task again, one period after the new time at most, when the clock goes back.
+    void restartReleases(double now, double previous)
+    {
+        vector<Release> restarted;
+        while (!releases.empty())
+        {
+            Release release = releases.top();
+            releases.pop();
+            release.time = now + min(max(release.time - previous, 0.0), tasks[release.task].period);
+            restarted.push_back(release);
+        }
+        for (const Release &release : restarted)
+        {
+            releases.push(release);
+        }
+    }
+
+    void workerLoop()
+    {
+        int currentPriority = -1;
+        while (true)
+        {
+            Job job;
+            {
+                unique_lock<mutex> lock(executorMutex);
+                jobReady.wait(lock, [this]
+                              { return stopping || !ready.empty(); });
+                if (ready.empty())
+                {
+                    return; // Stopping, and every released task has run.
+                }
+                job = ready.top();
+                ready.pop();
+            }
+
+            Task &task = tasks[job.task];
+            if (realtimePriority > 0 && realtimePriority + task.priority != currentPriority)
+            {
+                currentPriority = setWorkerPriority(realtimePriority + task.priority);
+            }
+
+            uint64_t start = monotonicNanoseconds();
+            task.body();
+            uint64_t end = monotonicNanoseconds();
+
+            // Counted in the task metrics, which are printed at termination and on SIGUSR1.
+            bool missed = end - job.dispatched > uint64_t(task.deadline / clock.getMultiplier() * 1e9);
+            task.metrics->recordRun(start - job.dispatched, end - start, missed);
+
+            lock_guard<mutex> lock(executorMutex);
+            task.running = false;
+        }
+    }
+
+    // Returns the priority set, or the given one if the worker could not be given it.
+    int setWorkerPriority(int priority)
+    {
+        sched_param parameters = {};
+        parameters.sched_priority = min(priority, sched_get_priority_max(SCHED_FIFO));
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+        if (error != 0 && !realtimeRefused.exchange(true))
+        {
+            asyncLog.log(LOG_WARNING, "Unable to run the periodic tasks under SCHED_FIFO (error {}), they keep the default policy.", error);
+        }
+        return priority;
+    }
+
+    const SimClock &clock;
+    size_t workerCount;
+    int realtimePriority; // Lowest SCHED_FIFO priority of the workers, 0 for the default policy
+    vector<Task> tasks;   // Fixed once run() is called
+    priority_queue<Release> releases; // Only used by the thread that calls run()
+    priority_queue<Job> ready;        // Released tasks waiting for a worker
+    vector<thread> workers;
+    mutex executorMutex; // Protects the ready queue and the running flags
+    condition_variable jobReady;
+    bool stopping;
+    atomic<bool> realtimeRefused{false};
+};
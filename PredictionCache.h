@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include "Aircraft.h"
+#include "ConflictKernel.h"
+
+using namespace std;
+
+/*NOTE: The prediction cache keeps the collision roots of every candidate pair between cycles.
+    A pair's roots only change when one of its aircrafts changes its speed, or leaves and enters
+    the airspace again. Every aircraft is given an epoch that changes when that happens, and a cached
+    prediction is only used while the epochs of both aircrafts are the ones it was computed with. */
+
+// Cached roots of a pair of aircrafts.
+struct CachedPrediction
+{
+    uint32_t firstEpoch;  // Epoch of the aircraft with the smallest ID when the roots were computed.
+    uint32_t secondEpoch; // Epoch of the aircraft with the largest ID when the roots were computed.
+    double referenceTime; // Time of the positions the roots were computed from.
+    uint64_t lastUsed;    // Last cycle the pair was a candidate.
+    CollisionRoots roots;
+};
+
+class PredictionCache
+{
+public:
+    // Constructor
+    PredictionCache()
+    {
+        cycle = 0;
+        nextEpoch = 1;
+        hits = 0;
+        misses = 0;
+        invalidations = 0;
+    }
+
+    // Updates the epochs of the aircrafts at the beginning of a cycle. Aircrafts that are new,
+    // or that changed their speed, get a new epoch, which invalidates all of their cached pairs.
+    void beginCycle(vector<Aircraft> &aircrafts)
+    {
+        cycle++;
+        epochsByIndex.resize(aircrafts.size());
+
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            Aircraft &aircraft = aircrafts[i];
+            auto found = epochs.find(aircraft.getAircraftID());
+
+            if (found == epochs.end() || found->second.speedX != aircraft.getSpeedX() ||
+                found->second.speedY != aircraft.getSpeedY() || found->second.speedZ != aircraft.getSpeedZ())
+            {
+                epochs[aircraft.getAircraftID()] = {aircraft.getSpeedX(), aircraft.getSpeedY(), aircraft.getSpeedZ(), nextEpoch++, cycle};
+            }
+            else
+            {
+                found->second.lastSeen = cycle;
+            }
+            epochsByIndex[i] = epochs[aircraft.getAircraftID()].epoch;
+        }
+
+        // Aircrafts that left the airspace lose their epoch, so they get a new one if they come back.
+        for (auto it = epochs.begin(); it != epochs.end();)
+        {
+            if (it->second.lastSeen != cycle)
+            {
+                it = epochs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Returns the cached prediction of the pair of aircrafts at indices i and j, or nullptr if it must be computed again.
+    // Safe to call from several threads at once, as long as no prediction is stored at the same time.
+    CachedPrediction *find(vector<Aircraft> &aircrafts, int i, int j)
+    {
+        int idI = aircrafts[i].getAircraftID();
+        int idJ = aircrafts[j].getAircraftID();
+        auto found = entries.find(pairKey(idI, idJ));
+        if (found == entries.end())
+        {
+            misses.fetch_add(1, memory_order_relaxed);
+            return nullptr;
+        }
+
+        uint32_t firstEpoch = (idI < idJ) ? epochsByIndex[i] : epochsByIndex[j];
+        uint32_t secondEpoch = (idI < idJ) ? epochsByIndex[j] : epochsByIndex[i];
+        CachedPrediction &prediction = found->second;
+        if (prediction.firstEpoch != firstEpoch || prediction.secondEpoch != secondEpoch)
+        {
+            invalidations.fetch_add(1, memory_order_relaxed);
+            misses.fetch_add(1, memory_order_relaxed);
+            return nullptr;
+        }
+
+        // Each pair is only visited by one thread per cycle.
+        prediction.lastUsed = cycle;
+        hits.fetch_add(1, memory_order_relaxed);
+        return &prediction;
+    }
+
+    // Stores the roots of the pair of aircrafts at indices i and j, computed from the positions at referenceTime.
+    void store(vector<Aircraft> &aircrafts, int i, int j, double referenceTime, const CollisionRoots &roots)
+    {
+        int idI = aircrafts[i].getAircraftID();
+        int idJ = aircrafts[j].getAircraftID();
+        CachedPrediction &prediction = entries[pairKey(idI, idJ)];
+        prediction.firstEpoch = (idI < idJ) ? epochsByIndex[i] : epochsByIndex[j];
+        prediction.secondEpoch = (idI < idJ) ? epochsByIndex[j] : epochsByIndex[i];
+        prediction.referenceTime = referenceTime;
+        prediction.lastUsed = cycle;
+        prediction.roots = roots;
+    }
+
+    // Drops the predictions of the pairs that were not candidates during this cycle.
+    void endCycle()
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.lastUsed != cycle)
+            {
+                it = entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    // Epoch of the aircraft at the given index in the aircrafts vector, during the current cycle.
+    uint32_t getEpoch(size_t index) const
+    {
+        return epochsByIndex[index];
+    }
+
+    // Counters since the cache was created.
+    uint64_t getHits() const
+    {
+        return hits;
+    }
+
+    uint64_t getMisses() const
+    {
+        return misses;
+    }
+
+    uint64_t getInvalidations() const
+    {
+        return invalidations;
+    }
+
+private:
+    struct AircraftEpoch
+    {
+        double speedX, speedY, speedZ; // Speed of the aircraft when the epoch was given.
+        uint32_t epoch;
+        uint64_t lastSeen; // Last cycle the aircraft was in the airspace.
+    };
+
+    static uint64_t pairKey(int idA, int idB)
+    {
+        return (uint64_t(uint32_t(min(idA, idB))) << 32) | uint32_t(max(idA, idB));
+    }
+
+    uint64_t cycle;
+    uint32_t nextEpoch;
+    unordered_map<int, AircraftEpoch> epochs;          // Epoch of every aircraft in the airspace, by aircraft ID.
+    vector<uint32_t> epochsByIndex;                    // Epoch of every aircraft, by index in the aircrafts vector.
+    unordered_map<uint64_t, CachedPrediction> entries; // Cached predictions, by pair of aircraft IDs.
+    atomic<uint64_t> hits;
+    atomic<uint64_t> misses;
+    atomic<uint64_t> invalidations;
+};
@@ -12,12 +12,20 @@
 #include <semaphore.h>
 #include <unistd.h>
 #include <thread>
+#include <queue>
+#include "RadarData.h"
+#include "Options.h"
+#include "SimClock.h"
+#include "Scenario.h"
+#include "Doorbell.h"
+#include "AsyncLog.h"
+#include "TaskMetrics.h"
+#include "Metrics.h"
 
 using namespace std;
 
 // shared memory and sempahore declaration for radar-computer and communications-radar communication
 #define shared_name "/radar_shm"
-#define sem_name "/radar_semaphore"
 #define shared_comms_name "/shm_communication"
 #define sem_comms_name "/comm_semaphore"
 
@@ -29,113 +37,176 @@ const char *shm_termination = "/shm_term";
 const char *sem_termination = "/term_semaphore";
 const int size3 = 64;
 
-int max_planes = 20; // maximum amount of planes allowed
+int max_planes = DEFAULT_RADAR_CAPACITY; // maximum amount of planes allowed, set with "--capacity N"
 
-const string filename = "Input_Medium.txt"; // file to be read from either with low, medium, or high traffic
+string filename = "Input_Medium.txt"; // file to be read from either with low, medium, or high traffic, set with "--scenario PATH"
+ScenarioReader *scenario;             // aircrafts that have not been read yet
 
-time_t programStartTime; // start time of program
-
-struct SharedAircraft
-{ // aircraft object layout
-    int aircraftID;
-    double positionX, positionY, positionZ;
-    double speedX, speedY, speedZ;
-    int startTime;
+struct StartsLater
+{ // orders the pending aircrafts so the first one to start is at the top of the heap
+    bool operator()(const SharedAircraft &a, const SharedAircraft &b) const
+    {
+        return a.startTime > b.startTime;
+    }
 };
+priority_queue<SharedAircraft, vector<SharedAircraft>, StartsLater> pendingAircraft; // aircrafts read from the scenario that have not entered the airspace yet
+bool airspaceFull = false;            // an aircraft is waiting for a free slot in the list
+
+int updateRate = 10;          // radar updates per second, set with "--rate HZ"
+double speedMultiplier = 1.0; // simulated seconds per real second, set with "--speed N"
+SimClock *simClock;           // simulation clock driven by the radar, followed by the computer and the visual display
+uint64_t simulationSteps = 0; // steps simulated since the aircrafts were loaded
+double simulationTime = 0;    // seconds simulated since the aircrafts were loaded
+uint64_t lateSteps = 0;    // steps that started after their deadline and had to catch up
 
 vector<SharedAircraft> aircrafting;
 
 int shm_fd, shm_fdd;
 
-SharedAircraft *sharedAircraftList; // aircraft list
+void *radarSegment;                 // radar shared memory, header followed by the aircraft list
+RadarHeader *radarHeader;           // sequence lock, capacity and live count of the aircraft list
+SharedAircraft *sharedAircraftList; // aircraft list, the live aircrafts are in the first liveCount slots
 
-mutex air_mutex, comms_mutex;
-sem_t *sem_plane;
-sem_t *sem_comms;
+RegistryEntry *registry;             // slot of every live aircraft, by ID, shared with the other subsystems
+size_t registryEntries;              // number of entries in the registry
 
-void printData()
-{                        // function which prints updates and prints aircraft positions
-    sem_wait(sem_plane); // semaphore and mutex below for critical section of updating aircrafts
-    lock_guard<mutex> lock(air_mutex);
-    time_t currentTime = time(nullptr);
+// airspace bounds set by the project, aircrafts outside of them leave the list
+const double AIRSPACE_X = 100000;
+const double AIRSPACE_Y = 100000;
+const double AIRSPACE_Z = 40000;
 
-    int elapsedProgramTime = currentTime - programStartTime; // elapsed time to determine when to put aircrafts into the system
+mutex air_mutex, comms_mutex; // air_mutex keeps the timer and the speed changes from updating the aircraft list at the same time
+sem_t *sem_comms;
+
+// adds an aircraft to the list, the caller must hold air_mutex and the write side of the sequence lock
+bool addAircraft(const SharedAircraft &aircraft)
+{
+    if (radarHeader->liveCount == uint32_t(max_planes))
+        return false;
 
-    cout << "[Time: " << elapsedProgramTime << "s] Updated Positions:" << endl;
+    uint32_t slot = radarHeader->liveCount++;
+    sharedAircraftList[slot] = aircraft;
+    registrySet(registry, registryEntries, aircraft.aircraftID, slot);
+    return true;
+}
 
-    for (int i = 0; i < max_planes; i++)
+// removes an aircraft from the list, the last live aircraft takes its slot so the list stays dense
+void removeAircraft(uint32_t slot)
+{
+    uint32_t last = --radarHeader->liveCount;
+    registryErase(registry, registryEntries, sharedAircraftList[slot].aircraftID);
+    if (slot != last)
     {
-        SharedAircraft &aircraft = sharedAircraftList[i];
+        sharedAircraftList[slot] = sharedAircraftList[last];
+        registrySet(registry, registryEntries, sharedAircraftList[slot].aircraftID, slot);
+    }
+    sharedAircraftList[last] = {};
+}
 
-        if (aircraft.startTime == -1)
-            continue;
+// slot of a live aircraft, or -1 if it is not in the airspace
+int findAircraft(int aircraftID)
+{
+    if (aircraftID == 0)
+        return -1;
+    size_t i = registryFind(registry, registryEntries, aircraftID);
+    return (registry[i].aircraftID == aircraftID) ? int(registry[i].slot) : -1;
+}
 
-        if (elapsedProgramTime < aircraft.startTime)
-        {
-            cout << "ID: " << aircraft.aircraftID << " | Waiting to start at " << aircraft.startTime << "s" << endl;
+bool inAirspace(const SharedAircraft &aircraft)
+{
+    return aircraft.positionX >= 0 && aircraft.positionX < AIRSPACE_X &&
+           aircraft.positionY >= 0 && aircraft.positionY < AIRSPACE_Y &&
+           aircraft.positionZ >= 0 && aircraft.positionZ < AIRSPACE_Z;
+}
+
+// moves the aircrafts whose start time has come from the scenario into the list, the caller must hold
+// air_mutex and the write side of the sequence lock
+void admitDueAircraft()
+{
+    // reading ahead by the disorder of the scenario, every aircraft due by now has been read
+    SharedAircraft aircraft;
+    while (scenario->peek(aircraft) && aircraft.startTime <= simulationTime + scenario->getDisorder())
+    {
+        pendingAircraft.push(aircraft);
+        scenario->pop();
+    }
+
+    while (!pendingAircraft.empty() && pendingAircraft.top().startTime <= simulationTime)
+    {
+        aircraft = pendingAircraft.top();
+        if (aircraft.aircraftID <= 0 || findAircraft(aircraft.aircraftID) != -1)
+        { // the ID would no longer name a single aircraft
+            asyncLog.log(LOG_WARNING, "Aircraft {} has an invalid ID or is already in the airspace, it is ignored", aircraft.aircraftID);
+            pendingAircraft.pop();
             continue;
         }
+        if (!addAircraft(aircraft))
+        { // the aircraft enters as soon as another one leaves
+            if (!airspaceFull)
+                asyncLog.log(LOG_WARNING, "Aircraft list full ({} aircrafts), aircraft {} waits for a free slot", max_planes, aircraft.aircraftID);
+            airspaceFull = true;
+            return;
+        }
+        pendingAircraft.pop();
+        airspaceFull = false;
+    }
+}
+
+void integrateStep(double dt)
+{ // advances every aircraft that has started by one step of dt seconds
+    lock_guard<mutex> lock(air_mutex);
+    simulationSteps++;
+    simulationTime = double(simulationSteps) / updateRate; // counted in steps, so rounding errors do not add up
 
-        double elapsedTime = elapsedProgramTime - aircraft.startTime;
+    // the computer never blocks the update, it copies the list again if it was updated while it was reading
+    beginRadarWrite(radarHeader);
+    for (int k = int(radarHeader->liveCount) - 1; k >= 0; k--)
+    { // backwards, so the aircraft moved into slot k by a removal was already updated
+        SharedAircraft &aircraft = sharedAircraftList[k];
 
-        if (aircraft.positionX < 100000 || aircraft.positionY < 100000 || aircraft.positionZ < 40000)
+        if (inAirspace(aircraft))
         { // only update aircrafts if they are within bounds set by the project
-            aircraft.positionX += aircraft.speedX * elapsedTime;
-            aircraft.positionY += aircraft.speedY * elapsedTime;
-            aircraft.positionZ += aircraft.speedZ * elapsedTime;
+            aircraft.positionX += aircraft.speedX * dt;
+            aircraft.positionY += aircraft.speedY * dt;
+            aircraft.positionZ += aircraft.speedZ * dt;
         }
         else
         {
-            sharedAircraftList[i] = {};
+            removeAircraft(k);
         }
-
-        cout << "ID: " << aircraft.aircraftID
-             << " | X: " << aircraft.positionX
-             << " | Y: " << aircraft.positionY
-             << " | Z: " << aircraft.positionZ << endl;
     }
-    cout << endl;
-    sem_post(sem_plane);
+    admitDueAircraft();
+    endRadarWrite(radarHeader);
 }
 
-void loadAircraftFromFile()
-{ // load aircrafts from the file chosen into the sharedaircraft list
-    ifstream file(filename);
-    if (!file)
-    {
-        cerr << "Error opening file: " << filename << endl;
-        exit(EXIT_FAILURE);
-    }
+void printData()
+{ // function which prints aircraft positions, the console is written by the log thread so the lock is only held to copy them
+    lock_guard<mutex> lock(air_mutex);
 
-    int i = 0;
-    while (file && i < max_planes)
+    asyncLog.log(LOG_INFO, "[Time: {}s] Updated Positions ({} late steps, {} aircrafts waiting to start):", simulationTime, lateSteps, pendingAircraft.size());
+
+    if (asyncLog.enabled(LOG_INFO))
     {
-        SharedAircraft aircraft;
-        if (file >> aircraft.aircraftID >> aircraft.positionX >> aircraft.positionY >> aircraft.positionZ >> aircraft.speedX >> aircraft.speedY >> aircraft.speedZ >> aircraft.startTime)
-        {
-            sharedAircraftList[i] = aircraft;
-            i++;
-        }
-        else
+        for (uint32_t k = 0; k < radarHeader->liveCount; k++)
         {
+            SharedAircraft &aircraft = sharedAircraftList[k];
 
-            if (file.eof())
-            { // fixed issue where duplicate last entry appeared
-                break;
-            }
-            else
-            {
-                cerr << "Error reading data!" << endl;
-                file.ignore(numeric_limits<streamsize>::max(), '\n');
-            }
+            asyncLog.log(LOG_INFO, "ID: {} | X: {} | Y: {} | Z: {}", aircraft.aircraftID, aircraft.positionX, aircraft.positionY, aircraft.positionZ);
         }
     }
-    file.close();
+    asyncLog.log(LOG_INFO, "");
 }
 
-void timerHandler(union sigval sv)
-{ // function which calls the printData functions
-    printData();
+void loadAircraftFromFile()
+{ // opens the scenario, the aircrafts are read from it when their start time comes
+    scenario = new ScenarioReader(filename);
+    if (scenario->getDisorder() > 0)
+        asyncLog.log(LOG_INFO, "Scenario {} is not sorted by start time, it is read {}s ahead", filename.c_str(), scenario->getDisorder());
+
+    lock_guard<mutex> lock(air_mutex);
+    beginRadarWrite(radarHeader);
+    admitDueAircraft();
+    endRadarWrite(radarHeader);
 }
 
 void initializeSharedMemory()
@@ -147,74 +218,100 @@ void initializeSharedMemory()
         exit(EXIT_FAILURE);
     }
 
-    if (ftruncate(shm_fd, max_planes * sizeof(SharedAircraft)) == -1)
+    if (ftruncate(shm_fd, radarSegmentSize(max_planes)) == -1)
     {
         cerr << "Error setting shared memory size" << endl;
         exit(EXIT_FAILURE);
     }
 
-    sharedAircraftList = (SharedAircraft *)mmap(0, max_planes * sizeof(SharedAircraft), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    if (sharedAircraftList == MAP_FAILED)
+    radarSegment = mmap(0, radarSegmentSize(max_planes), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (radarSegment == MAP_FAILED)
     {
         cerr << "Error mapping shared memory" << endl;
         exit(EXIT_FAILURE);
     }
 
-    for (int i = 0; i < max_planes; i++)
-    {
-        sharedAircraftList[i].startTime = -1;
-    }
+    radarHeader = static_cast<RadarHeader *>(radarSegment);
+    radarHeader->magic = 0; // the segment may be left over from a previous run
+    radarHeader->sequence.store(0);
+    radarHeader->capacity = max_planes;
+    radarHeader->liveCount = 0;
+    sharedAircraftList = radarRecords(radarSegment);
+    registry = radarRegistry(radarSegment);
+    registryEntries = radarRegistrySize(max_planes);
+    memset(static_cast<void *>(registry), 0, registryEntries * sizeof(RegistryEntry));
+
+    // the other subsystems only map the whole list once the header is complete
+    radarHeader->version = RADAR_VERSION;
+    atomic_thread_fence(memory_order_release);
+    radarHeader->magic = RADAR_MAGIC;
 }
 
-void startTimer()
-{ // timer which calls the function to update aircraft data every second
-    timer_t timer_id;
-    struct sigevent sev;
-    struct itimerspec its;
-
-    sev.sigev_notify = SIGEV_THREAD;
-    sev.sigev_notify_function = timerHandler; // function to call
-    sev.sigev_value.sival_ptr = nullptr;
-    sev.sigev_notify_attributes = nullptr;
-
-    if (timer_create(CLOCK_REALTIME, &sev, &timer_id) == -1)
-    {
-        cerr << "Error creating timer: " << strerror(errno) << endl;
-        exit(EXIT_FAILURE);
-    }
-
-    its.it_value.tv_sec = 1;
-    its.it_value.tv_nsec = 0;
-    its.it_interval.tv_sec = 1;
-    its.it_interval.tv_nsec = 0;
+void runSimulation()
+{ // updates the aircrafts at a fixed rate on one thread, against absolute deadlines so the period never drifts
+    const long simulatedStepNanoseconds = 1000000000L / updateRate;
+    const long stepNanoseconds = long(simulatedStepNanoseconds / speedMultiplier); // real time between steps
+    const double dt = 1.0 / updateRate;
+    TaskMetrics &stepMetrics = taskMetrics.add("radar step", stepNanoseconds / 1e9);
 
-    if (timer_settime(timer_id, 0, &its, nullptr) == -1)
-    {
-        cerr << "Error setting timer: " << strerror(errno) << endl;
-        exit(EXIT_FAILURE);
-    }
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
 
     while (true)
     {
-        sleep(1);
-    }
-}
-void changeSpeed(int passedID, int speedx, int speedy, int speedz)
-{ // function which updates selected aircraft's speed
+        deadline.tv_nsec += stepNanoseconds;
+        while (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
 
-    for (int i = 0; i < max_planes; i++)
-    {
-        SharedAircraft &aircraft = sharedAircraftList[i];
+        int error;
+        while ((error = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr)) == EINTR)
+            ;
+        if (error != 0)
+        {
+            cerr << "Error waiting for the next radar update: " << strerror(error) << endl;
+            exit(EXIT_FAILURE);
+        }
 
-        if (aircraft.aircraftID == passedID)
+        { // timed from the deadline of the step, which the step started late by its jitter
+            int64_t jitter = int64_t(monotonicNanoseconds()) - (int64_t(deadline.tv_sec) * 1000000000L + deadline.tv_nsec);
+            ScopedTaskTimer timer(stepMetrics, (jitter > 0) ? jitter : 0);
+            integrateStep(dt);
+            simClock->advance(simulationSteps * simulatedStepNanoseconds); // once the aircrafts are at that time
+        }
+        systemMetrics.add(RADAR_STEPS);
+        systemMetrics.set(RADAR_AIRCRAFTS, radarHeader->liveCount);
+
+        // after an overrun the following deadlines are already past, so the steps run back to back until
+        // the simulation has caught up with the clock
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t lateness = int64_t(now.tv_sec - deadline.tv_sec) * 1000000000L + (now.tv_nsec - deadline.tv_nsec);
+        if (lateness > stepNanoseconds)
         {
-            aircraft.speedX = speedx;
-            aircraft.speedY = speedy;
-            aircraft.speedZ = speedz;
+            lateSteps++;
+            systemMetrics.add(RADAR_LATE_STEPS);
         }
+
+        if (simulationSteps % updateRate == 0)
+            printData(); // once per simulated second
     }
 }
 
+void changeSpeed(int passedID, int speedx, int speedy, int speedz)
+{ // function which updates selected aircraft's speed, the caller must hold air_mutex and the write side of the sequence lock
+    int slot = findAircraft(passedID);
+    if (slot == -1)
+        return; // the aircraft has left the airspace
+
+    SharedAircraft &aircraft = sharedAircraftList[slot];
+    aircraft.speedX = speedx;
+    aircraft.speedY = speedy;
+    aircraft.speedZ = speedz;
+}
+
 void changeParameters()
 { // opens shared memory with communications
     sem_comms = sem_open(sem_comms_name, O_CREAT, 0777, 1);
@@ -231,8 +328,15 @@ void changeParameters()
         exit(EXIT_FAILURE);
     }
 
-    SharedAircraft *sharedComms = (SharedAircraft *)mmap(0, sizeof(SharedAircraft) * max_planes, PROT_READ, MAP_SHARED, shm_fd_comms, 0);
-    if (sharedComms == MAP_FAILED)
+    // the speed changes follow the command written by the computer, with one entry per aircraft at most
+    if (ensureSegmentSize(shm_fd_comms, communicationSegmentSize(max_planes)) == -1)
+    {
+        perror("failed to size shared memory");
+        exit(EXIT_FAILURE);
+    }
+
+    void *commsSegment = mmap(0, communicationSegmentSize(max_planes), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_comms, 0);
+    if (commsSegment == MAP_FAILED)
     {
         perror("Failed to map shared memory");
         sem_close(sem_comms);
@@ -240,28 +344,57 @@ void changeParameters()
         exit(EXIT_FAILURE);
     }
 
-    cout << "Radar: Communications shared memory received" << endl;
+    SpeedChangeHeader *commsHeader = speedChangeHeader(commsSegment);
+    SpeedChange *sharedComms = speedChanges(commsSegment);
+    Doorbell doorbell(RADAR_DOORBELL); // rung by communications once it has listed a request
+    TaskMetrics &speedChangeMetrics = taskMetrics.add("speed changes");
+    HopLatency &communicationHop = taskMetrics.addHop("Communication -> Radar");
+    HopLatency &operatorToRadar = taskMetrics.addHop("Operator -> Radar");
+    vector<SpeedChange> applied; // requests applied by the last update, their latencies are printed once the locks are released
+
+    sem_wait(sem_comms);
+    commsHeader->capacity = max_planes;
+    sem_post(sem_comms);
+
+    asyncLog.log(LOG_INFO, "Radar: Communications shared memory received");
 
     while (true)
     {
+        doorbell.wait(1.0); // the list is still checked every second without a ring
+
         sem_wait(sem_comms);
-        lock_guard<mutex> lock(comms_mutex);
-
-        for (int i = 0; i < max_planes; i++)
-        { // takes request from communications to change speed and calls changespeed function
-            SharedAircraft &aircraftComms = sharedComms[i];
-            if (aircraftComms.aircraftID == 0)
-                continue;
-
-            changeSpeed(
-                aircraftComms.aircraftID,
-                aircraftComms.speedX,
-                aircraftComms.speedY,
-                aircraftComms.speedZ);
+        unique_lock<mutex> lock(comms_mutex);
+
+        uint32_t pending = min(commsHeader->count, uint32_t(max_planes));
+        if (pending > 0)
+        { // the pending requests are applied in a single update of the list, only these updates are timed
+            ScopedTaskTimer timer(speedChangeMetrics);
+            lock_guard<mutex> airLock(air_mutex);
+            beginRadarWrite(radarHeader);
+            for (uint32_t i = 0; i < pending; i++)
+            { // takes the pending requests from communications to change speed and calls changespeed function
+                SpeedChange &aircraftComms = sharedComms[i];
+
+                changeSpeed(
+                    aircraftComms.aircraftID,
+                    aircraftComms.speedX,
+                    aircraftComms.speedY,
+                    aircraftComms.speedZ);
+            }
+            endRadarWrite(radarHeader);
+            systemMetrics.add(RADAR_SPEED_CHANGES, pending);
         }
+        applied.assign(sharedComms, sharedComms + pending);
+        commsHeader->count = 0; // every request is applied once
 
         sem_post(sem_comms);
-        sleep(1); // check for updates every second
+        lock.unlock();
+
+        for (SpeedChange &change : applied)
+        {
+            communicationHop.record(change.forwardedAt);
+            operatorToRadar.record(change.issuedAt);
+        }
     }
 }
 
@@ -312,7 +445,8 @@ void monitorTermination()
     {
         if (checkTermination())
         {
-            cout << "Termination signal received. Terminating radar subsystem." << endl;
+            asyncLog.log(LOG_INFO, "Termination signal received. Terminating radar subsystem.");
+            taskMetrics.print(cout); // timing of every task and hop over the whole run
 
             sem_wait(sem_term);
             strncpy((char *)shm_ptr_term, "Radar", size3 - 1);
@@ -323,13 +457,15 @@ void monitorTermination()
             close(shm_fd_term);
             sem_close(sem_term);
 
-            munmap(sharedAircraftList, max_planes * sizeof(SharedAircraft));
+            munmap(radarSegment, radarSegmentSize(max_planes));
             close(shm_fd);
-            sem_close(sem_plane);
             sem_close(sem_comms);
 
+            simClock->stop(); // the other subsystems go back to the wall clock
+
             shm_unlink(shared_name);
             shm_unlink(shm_termination);
+            shm_unlink(SIM_CLOCK_NAME);
 
             exit(0);
         }
@@ -338,14 +474,71 @@ void monitorTermination()
     }
 }
 
-int main()
+const char *RADAR_USAGE = "Usage: Radar [--capacity N] [--rate HZ] [--speed N] [--scenario PATH] [--verbosity N]";
+
+int main(int argc, char *argv[])
 {
+    // the number of aircrafts the radar can track can be set with "--capacity N", its updates per second with "--rate HZ",
+    // the speed of the simulation with "--speed N" (N times real time, from 0.01 to 100), the scenario with "--scenario PATH",
+    // and the console output with "--verbosity N" (0 errors only, 1 warnings, 2 the positions of the aircrafts, 3 debugging)
+    installTaskMetricsSignal(); // "kill -USR1" prints the timing of the updates, before any thread is started
+
+    LogLevel verbosity = LOG_INFO;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (i + 1 >= argc)
+        { // every option takes a value
+            cerr << "Missing value for " << option << endl
+                 << RADAR_USAGE << endl;
+            return 1;
+        }
+
+        try
+        {
+            if (option == "--capacity")
+            {
+                max_planes = parseInteger(argv[++i], 1, 1 << 20);
+            }
+            else if (option == "--rate")
+            {
+                updateRate = parseInteger(argv[++i], 1, 10000);
+            }
+            else if (option == "--scenario")
+            {
+                filename = argv[++i];
+            }
+            else if (option == "--speed")
+            {
+                speedMultiplier = parseNumber(argv[++i], 0.01, 100);
+            }
+            else if (option == "--verbosity")
+            {
+                verbosity = parseLogLevel(argv[++i]);
+            }
+            else
+            {
+                cerr << "Unknown option: " << option << endl
+                     << RADAR_USAGE << endl;
+                return 1;
+            }
+        }
+        catch (const logic_error &)
+        { // not a number, or out of range
+            cerr << "Invalid value for " << option << ": " << argv[i] << endl
+                 << RADAR_USAGE << endl;
+            return 1;
+        }
+    }
+    asyncLog.start(verbosity);
+    systemMetrics.open();
 
+    simClock = new SimClock();
+    simClock->start(speedMultiplier);
     initializeSharedMemory();
     startTerminationMonitor();
     loadAircraftFromFile();
-    programStartTime = time(nullptr);
-    thread t1(startTimer); // threads to make updating aircraft psoitions and speed change request run simultaneously
+    thread t1(runSimulation); // threads to make updating aircraft psoitions and speed change request run simultaneously
     thread t2(changeParameters);
     thread t3(monitorTermination);
 
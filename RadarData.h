@@ -0,0 +1,299 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SharedState.h"
+
+using namespace std;
+
+/*NOTE: Layout of the radar shared memory ("/radar_shm"), written by the Radar and read by the Computer.
+    The table is published through a sequence lock: the Radar makes the sequence odd before it updates
+    the table and even again once it is done, without ever waiting for a reader. A reader copies the
+    table and keeps the copy only if the sequence was even and did not change while it was copying,
+    otherwise the copy may be torn and it copies the table again.
+
+    The Radar sizes the table at startup, and every other subsystem reads the capacity from the header
+    before mapping the whole segment. The live aircrafts are kept densely at the start of the table:
+    an aircraft that leaves is replaced by the last one, so readers copy the live aircrafts in one
+    contiguous block and never see an empty slot.
+
+    The table is followed by the ID registry, an open-addressing hash table from aircraft ID to slot,
+    kept by the Radar under the same sequence lock, so every subsystem finds an aircraft by its ID
+    without scanning the table. The registry has at least twice as many entries as the table has
+    slots, and entries are removed by shifting the following ones back, so probes stay short. */
+
+const uint32_t RADAR_MAGIC = 0x52444152; // "RADR"
+const uint32_t RADAR_VERSION = 3;
+const uint32_t DEFAULT_RADAR_CAPACITY = 1024; // Number of aircrafts the Radar can track, unless configured otherwise
+
+struct SharedAircraft
+{ // aircraft object layout
+    int aircraftID;
+    double positionX, positionY, positionZ;
+    double speedX, speedY, speedZ;
+    int startTime;
+};
+
+struct RadarHeader
+{
+    atomic<uint64_t> sequence; // Odd while the Radar is updating the table.
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;  // Number of slots in the table.
+    uint32_t liveCount; // Number of live aircrafts, in the first slots of the table.
+};
+
+struct RegistryEntry
+{
+    int32_t aircraftID; // 0 for an empty entry.
+    uint32_t slot;      // Slot of the aircraft in the table.
+};
+
+// Number of registry entries, a power of two at least twice the capacity of the table.
+inline size_t radarRegistrySize(size_t capacity)
+{
+    size_t entries = 2;
+    while (entries < 2 * capacity)
+    {
+        entries *= 2;
+    }
+    return entries;
+}
+
+inline size_t radarSegmentSize(size_t capacity)
+{
+    return sizeof(RadarHeader) + capacity * sizeof(SharedAircraft) + radarRegistrySize(capacity) * sizeof(RegistryEntry);
+}
+
+inline SharedAircraft *radarRecords(void *segment)
+{
+    return reinterpret_cast<SharedAircraft *>(static_cast<char *>(segment) + sizeof(RadarHeader));
+}
+
+inline RegistryEntry *radarRegistry(void *segment)
+{
+    uint32_t capacity = static_cast<RadarHeader *>(segment)->capacity;
+    return reinterpret_cast<RegistryEntry *>(static_cast<char *>(segment) + sizeof(RadarHeader) + capacity * sizeof(SharedAircraft));
+}
+
+// Home entry of an ID, IDs are often consecutive so they are mixed before being masked.
+inline size_t registryHome(int32_t aircraftID, size_t mask)
+{
+    uint32_t hash = uint32_t(aircraftID) * 2654435769u;
+    return (hash ^ (hash >> 16)) & mask;
+}
+
+// Entry holding the ID, or the empty entry where it would be inserted. The probe is bounded, so a
+// torn registry seen by a reader cannot keep it looping.
+inline size_t registryFind(const RegistryEntry *registry, size_t entries, int32_t aircraftID)
+{
+    size_t mask = entries - 1;
+    size_t i = registryHome(aircraftID, mask);
+    for (size_t probes = 0; probes < entries; probes++, i = (i + 1) & mask)
+    {
+        if (registry[i].aircraftID == aircraftID || registry[i].aircraftID == 0)
+        {
+            return i;
+        }
+    }
+    return entries; // Only possible in a torn copy, the Radar never fills the registry.
+}
+
+// Called by the Radar, under the write side of the sequence lock, to add an aircraft or move it to another slot.
+inline void registrySet(RegistryEntry *registry, size_t entries, int32_t aircraftID, uint32_t slot)
+{
+    size_t i = registryFind(registry, entries, aircraftID);
+    registry[i].aircraftID = aircraftID;
+    registry[i].slot = slot;
+}
+
+// Called by the Radar, under the write side of the sequence lock, when an aircraft leaves. The entries
+// after it are shifted back, so no probe ever stops early at the removed entry.
+inline void registryErase(RegistryEntry *registry, size_t entries, int32_t aircraftID)
+{
+    size_t mask = entries - 1;
+    size_t hole = registryFind(registry, entries, aircraftID);
+    if (hole == entries || registry[hole].aircraftID == 0)
+    {
+        return;
+    }
+
+    for (size_t i = (hole + 1) & mask; registry[i].aircraftID != 0; i = (i + 1) & mask)
+    {
+        // An entry can fill the hole if the hole lies between its home and itself.
+        size_t home = registryHome(registry[i].aircraftID, mask);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            registry[hole] = registry[i];
+            hole = i;
+        }
+    }
+    registry[hole] = {};
+}
+
+// Called by the Radar before it updates the table. The Radar must not update the table from two threads at once.
+inline void beginRadarWrite(RadarHeader *header)
+{
+    header->sequence.store(header->sequence.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Called by the Radar once the table is updated.
+inline void endRadarWrite(RadarHeader *header)
+{
+    header->sequence.store(header->sequence.load(memory_order_relaxed) + 1, memory_order_release);
+}
+
+// Copies the live aircrafts of the table into "copy", without blocking the Radar, and the sequence it was
+// copied at into "generation" if given: the copy is the same as the last one when the sequence is.
+// Returns the number of torn copies that had to be discarded.
+inline size_t readRadarSnapshot(void *segment, vector<SharedAircraft> &copy, uint64_t *generation = nullptr)
+{
+    RadarHeader *header = static_cast<RadarHeader *>(segment);
+    SharedAircraft *records = radarRecords(segment);
+    uint32_t capacity = header->capacity; // Never changes once the Radar has created the table.
+    size_t retries = 0;
+
+    while (true)
+    {
+        uint64_t before = header->sequence.load(memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+            // A torn copy may hold any count, so it is bounded before being used.
+            uint32_t liveCount = min(header->liveCount, capacity);
+            copy.resize(liveCount);
+            memcpy(static_cast<void *>(copy.data()), records, liveCount * sizeof(SharedAircraft));
+
+            atomic_thread_fence(memory_order_acquire);
+            if (header->sequence.load(memory_order_relaxed) == before)
+            {
+                if (generation)
+                {
+                    *generation = before;
+                }
+                return retries;
+            }
+        }
+        retries++;
+        this_thread::yield(); // The Radar is in the middle of an update.
+    }
+}
+
+// Copies the live aircraft with the given ID, without blocking the Radar. Returns false if it is not in the table.
+inline bool readRadarAircraft(void *segment, int32_t aircraftID, SharedAircraft &aircraft)
+{
+    RadarHeader *header = static_cast<RadarHeader *>(segment);
+    SharedAircraft *records = radarRecords(segment);
+    RegistryEntry *registry = radarRegistry(segment);
+    uint32_t capacity = header->capacity;
+    size_t entries = radarRegistrySize(capacity);
+
+    if (aircraftID == 0)
+    {
+        return false; // Marks the empty entries of the registry.
+    }
+
+    while (true)
+    {
+        uint64_t before = header->sequence.load(memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+            // A torn copy may hold any slot, so it is bounded before being used.
+            size_t i = registryFind(registry, entries, aircraftID);
+            bool found = i < entries && registry[i].aircraftID == aircraftID && registry[i].slot < min(header->liveCount, capacity);
+            if (found)
+            {
+                aircraft = records[registry[i].slot];
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+            if (header->sequence.load(memory_order_relaxed) == before)
+            {
+                return found && aircraft.aircraftID == aircraftID;
+            }
+        }
+        this_thread::yield(); // The Radar is in the middle of an update.
+    }
+}
+
+// Maps the radar shared memory, reading its capacity from the header first. Returns MAP_FAILED on failure.
+inline void *mapRadarSegment(int fd, int protection, size_t &segmentSize)
+{
+    void *header = mmap(0, sizeof(RadarHeader), PROT_READ, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED)
+    {
+        return MAP_FAILED;
+    }
+
+    RadarHeader copy;
+    memcpy(static_cast<void *>(&copy), header, sizeof(RadarHeader));
+    munmap(header, sizeof(RadarHeader));
+    if (copy.magic != RADAR_MAGIC || copy.version != RADAR_VERSION)
+    {
+        errno = EINVAL; // Not created by this version of the Radar.
+        return MAP_FAILED;
+    }
+
+    segmentSize = radarSegmentSize(copy.capacity);
+    return mmap(0, segmentSize, protection, MAP_SHARED, fd, 0);
+}
+
+// Grows the shared memory to at least "size" bytes, without shrinking it under another subsystem. Returns -1 on failure.
+inline int ensureSegmentSize(int fd, size_t size)
+{
+    struct stat status;
+    if (fstat(fd, &status) == -1)
+    {
+        return -1;
+    }
+    if (size_t(status.st_size) >= size)
+    {
+        return 0;
+    }
+    return ftruncate(fd, size);
+}
+
+// Speed changes ("/shm_communication")
+// The text command written by the Computer is followed by the list of speed changes that the
+// Communication subsystem sends to the Radar. The list holds one entry per aircraft at most, so it has
+// the capacity of the radar table.
+const size_t COMMAND_AREA_SIZE = 256; // Size of the text command written by the Computer.
+
+struct SpeedChange
+{
+    int32_t aircraftID;
+    int32_t reserved;
+    double speedX, speedY, speedZ;
+    uint64_t issuedAt;    // CLOCK_MONOTONIC nanoseconds at which the Operator issued the command, 0 if unknown.
+    uint64_t forwardedAt; // CLOCK_MONOTONIC nanoseconds at which the Communication subsystem listed it.
+};
+
+struct SpeedChangeHeader
+{
+    uint32_t count;    // Number of pending speed changes, at the start of the list.
+    uint32_t capacity; // Number of entries in the list.
+};
+
+inline size_t communicationSegmentSize(size_t capacity)
+{
+    return COMMAND_AREA_SIZE + sizeof(SpeedChangeHeader) + capacity * sizeof(SpeedChange);
+}
+
+inline SpeedChangeHeader *speedChangeHeader(void *segment)
+{
+    return reinterpret_cast<SpeedChangeHeader *>(static_cast<char *>(segment) + COMMAND_AREA_SIZE);
+}
+
+inline SpeedChange *speedChanges(void *segment)
+{
+    return reinterpret_cast<SpeedChange *>(static_cast<char *>(segment) + COMMAND_AREA_SIZE + sizeof(SpeedChangeHeader));
+}
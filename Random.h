@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+using namespace std;
+
+/*NOTE: SplitMix64, small and fully specified, so a seed gives the same sequence with every compiler and
+    library. The load and benchmark tools use it, with basic arithmetic only, so a seed gives the same
+    aircrafts on every machine. */
+
+class Random
+{
+public:
+    Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform integer in [low, high].
+    int64_t uniform(int64_t low, int64_t high)
+    {
+        return low + int64_t(next() % uint64_t(high - low + 1));
+    }
+
+    // Uniform double in [0, 1).
+    double unit()
+    {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    uint64_t state;
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "RadarData.h"
+
+using namespace std;
+
+/*NOTE: A scenario lists the aircrafts that enter the airspace, either as text, one "ID x y z vx vy vz startTime"
+    per line, or in the binary format below. The file is memory-mapped and the aircrafts are parsed one at
+    a time, when the Radar asks for the next one, so only the aircrafts that are about to enter the
+    airspace, or are in it, are ever held in memory.
+
+    The Radar holds the aircrafts it has read in a heap ordered by start time, and reads ahead of the
+    simulation by the disorder of the file: the largest number of seconds by which a start time comes
+    after a later one. Every aircraft due by a given time has then been read. The disorder is found by a
+    quick scan of the start times when the file is opened, it is 0 for a file sorted by start time. */
+
+const uint32_t SCENARIO_MAGIC = 0x314E4353; // "SCN1"
+const uint32_t SCENARIO_VERSION = 1;
+
+struct ScenarioHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count; // Number of records following the header.
+};
+
+struct ScenarioRecord
+{
+    int32_t aircraftID;
+    int32_t startTime;
+    double positionX, positionY, positionZ;
+    double speedX, speedY, speedZ;
+};
+
+class ScenarioReader
+{
+public:
+    // Constructor, exits if the scenario cannot be opened
+    ScenarioReader(const string &path)
+    {
+        errors = 0;
+        hasNext = false;
+
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            perror(("Error opening scenario " + path).c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) == -1)
+        {
+            perror("Error reading the size of the scenario");
+            exit(EXIT_FAILURE);
+        }
+
+        size = status.st_size;
+        begin = nullptr;
+        if (size > 0)
+        {
+            begin = static_cast<const char *>(mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0));
+            if (begin == MAP_FAILED)
+            {
+                perror("Error mapping the scenario");
+                exit(EXIT_FAILURE);
+            }
+            madvise(const_cast<char *>(begin), size, MADV_SEQUENTIAL);
+        }
+        end = begin + size;
+        cursor = begin;
+
+        // Binary scenarios start with their header.
+        binary = size >= sizeof(ScenarioHeader) && reinterpret_cast<const ScenarioHeader *>(begin)->magic == SCENARIO_MAGIC;
+        if (binary)
+        {
+            const ScenarioHeader *header = reinterpret_cast<const ScenarioHeader *>(begin);
+            if (header->version != SCENARIO_VERSION || header->count > (size - sizeof(ScenarioHeader)) / sizeof(ScenarioRecord))
+            {
+                cerr << "Unsupported or truncated binary scenario: " << path << endl;
+                exit(EXIT_FAILURE);
+            }
+            cursor = begin + sizeof(ScenarioHeader);
+            end = cursor + header->count * sizeof(ScenarioRecord);
+        }
+
+        disorder = scanDisorder();
+    }
+
+    // Destructor
+    ~ScenarioReader()
+    {
+        if (begin)
+        {
+            munmap(const_cast<char *>(begin), size);
+        }
+        close(fd);
+    }
+
+    // Returns the next aircraft without taking it, false once the scenario is over.
+    bool peek(SharedAircraft &aircraft)
+    {
+        if (!hasNext)
+        {
+            hasNext = parseNext(next);
+        }
+        aircraft = next;
+        return hasNext;
+    }
+
+    // Takes the aircraft returned by the last call to peek().
+    void pop()
+    {
+        hasNext = false;
+    }
+
+    // Largest number of seconds by which a start time comes after a later one in the file.
+    long getDisorder() const
+    {
+        return disorder;
+    }
+
+    // Lines of a text scenario that could not be read.
+    size_t getErrors() const
+    {
+        return errors;
+    }
+
+private:
+    // Parses the next aircraft at the cursor, skipping the lines that cannot be read.
+    bool parseNext(SharedAircraft &aircraft)
+    {
+        if (binary)
+        {
+            if (cursor >= end)
+            {
+                return false;
+            }
+            ScenarioRecord record;
+            memcpy(&record, cursor, sizeof(record));
+            cursor += sizeof(record);
+            aircraft = {record.aircraftID, record.positionX, record.positionY, record.positionZ,
+                        record.speedX, record.speedY, record.speedZ, record.startTime};
+            return true;
+        }
+
+        while (cursor < end)
+        {
+            const char *lineEnd = static_cast<const char *>(memchr(cursor, '\n', end - cursor));
+            if (!lineEnd)
+            {
+                lineEnd = end;
+            }
+            const char *line = cursor;
+            cursor = (lineEnd < end) ? lineEnd + 1 : end;
+
+            if (parseLine(line, lineEnd, aircraft))
+            {
+                return true;
+            }
+            if (!isBlank(line, lineEnd))
+            {
+                errors++;
+                cerr << "Error reading data!" << endl;
+            }
+        }
+        return false;
+    }
+
+    static bool parseLine(const char *p, const char *lineEnd, SharedAircraft &aircraft)
+    {
+        return parseField(p, lineEnd, aircraft.aircraftID) &&
+               parseField(p, lineEnd, aircraft.positionX) &&
+               parseField(p, lineEnd, aircraft.positionY) &&
+               parseField(p, lineEnd, aircraft.positionZ) &&
+               parseField(p, lineEnd, aircraft.speedX) &&
+               parseField(p, lineEnd, aircraft.speedY) &&
+               parseField(p, lineEnd, aircraft.speedZ) &&
+               parseField(p, lineEnd, aircraft.startTime) &&
+               isBlank(p, lineEnd);
+    }
+
+    // Integer fields.
+    template <typename T>
+    static bool parseField(const char *&p, const char *lineEnd, T &value)
+    {
+        while (p < lineEnd && isSpace(*p))
+        {
+            p++;
+        }
+        if (p < lineEnd && *p == '+')
+        {
+            p++; // from_chars does not accept a leading '+'
+        }
+        from_chars_result result = from_chars(p, lineEnd, value);
+        if (result.ec != errc() || result.ptr == p)
+        {
+            return false;
+        }
+        p = result.ptr;
+        return true;
+    }
+
+    // Floating point fields. from_chars only parses them from GCC 11, so the field is copied to a terminated
+    // buffer for strtod, which would otherwise read past the end of the mapping on the last line.
+    static bool parseField(const char *&p, const char *lineEnd, double &value)
+    {
+        while (p < lineEnd && isSpace(*p))
+        {
+            p++;
+        }
+        const char *fieldEnd = p;
+        while (fieldEnd < lineEnd && !isSpace(*fieldEnd))
+        {
+            fieldEnd++;
+        }
+
+        char field[64];
+        size_t length = fieldEnd - p;
+        if (length == 0 || length >= sizeof(field))
+        {
+            return false;
+        }
+        memcpy(field, p, length);
+        field[length] = '\0';
+        if (strspn(field, "+-.0123456789eE") < length)
+        {
+            return false; // no hexadecimal, inf or nan
+        }
+
+        char *parsed;
+        errno = 0;
+        value = strtod(field, &parsed);
+        if (parsed != field + length || errno == ERANGE || !isfinite(value))
+        {
+            return false;
+        }
+        p = fieldEnd;
+        return true;
+    }
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static bool isBlank(const char *p, const char *lineEnd)
+    {
+        while (p < lineEnd && isSpace(*p))
+        {
+            p++;
+        }
+        return p == lineEnd;
+    }
+
+    // Finds the disorder of the start times, reading only the last field of every line of a text scenario.
+    long scanDisorder() const
+    {
+        long latest = numeric_limits<long>::min(); // Latest start time so far.
+        long largest = 0;
+
+        if (binary)
+        {
+            for (const char *p = cursor; p < end; p += sizeof(ScenarioRecord))
+            {
+                int32_t startTime;
+                memcpy(&startTime, p + offsetof(ScenarioRecord, startTime), sizeof(startTime));
+                latest = max(latest, long(startTime));
+                largest = max(largest, latest - startTime);
+            }
+            return largest;
+        }
+
+        const char *p = cursor;
+        while (p < end)
+        {
+            const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (!lineEnd)
+            {
+                lineEnd = end;
+            }
+
+            // The start time is the last field of the line.
+            const char *fieldEnd = lineEnd;
+            while (fieldEnd > p && isSpace(fieldEnd[-1]))
+            {
+                fieldEnd--;
+            }
+            const char *fieldBegin = fieldEnd;
+            while (fieldBegin > p && !isSpace(fieldBegin[-1]))
+            {
+                fieldBegin--;
+            }
+
+            long startTime;
+            if (fieldBegin < fieldEnd && from_chars(fieldBegin, fieldEnd, startTime).ec == errc())
+            {
+                latest = max(latest, startTime);
+                largest = max(largest, latest - startTime);
+            }
+            p = (lineEnd < end) ? lineEnd + 1 : end;
+        }
+        return largest;
+    }
+
+    int fd;
+    size_t size;
+    const char *begin;  // Mapped file.
+    const char *end;    // End of the records.
+    const char *cursor; // Next record to parse.
+    bool binary;
+    size_t errors;
+    long disorder;
+
+    SharedAircraft next; // Aircraft returned by peek() and not taken yet.
+    bool hasNext;
+};
@@ -0,0 +1,269 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include "Scenario.h"
+#include "Random.h"
+#include "Options.h"
+
+using namespace std;
+
+/*NOTE: Generates load scenarios for the Radar, either in the text format ("ID x y z vx vy vz startTime")
+    or in the binary scenario format. The generator only uses the SplitMix64 generator of Random.h and
+    basic arithmetic on integers and doubles, so a seed gives the same scenario on every machine.
+
+    Usage: ScenarioGenerator [--seed N] [--count N] [--rate N] [--bands LOW,MID,HIGH] [--conflicts P]
+                             [--binary] [--output PATH]
+        --rate is the average number of aircrafts entering the airspace per second.
+        --bands are the weights of the low, middle and high altitude bands.
+        --conflicts is the fraction of aircrafts sent on a collision course with an aircraft already in the airspace. */
+
+// Airspace bounds, the same as the Radar's
+const int64_t AIRSPACE_X = 100000;
+const int64_t AIRSPACE_Y = 100000;
+const int64_t AIRSPACE_Z = 40000;
+
+// Altitude bands, in feet
+const int64_t BAND_LIMITS[4] = {1000, 10000, 25000, 39000};
+
+const int64_t MIN_SPEED = 100; // Horizontal speeds, in feet per second, along each axis
+const int64_t MAX_SPEED = 900;
+const int64_t MAX_CLIMB = 50; // Vertical speed, in feet per second
+
+const int64_t MIN_CONFLICT_TIME = 30; // Seconds between the entry of an aircraft and its conflict
+const int64_t MAX_CONFLICT_TIME = 120;
+const int CONFLICT_ATTEMPTS = 16; // Attempts to place a conflicting aircraft inside the airspace
+
+struct Settings
+{
+    uint64_t seed = 1;
+    size_t count = 100;
+    double rate = 1.0;
+    double bands[3] = {1, 1, 1};
+    double conflicts = 0.0;
+    bool binary = false;
+    string output; // Standard output when empty
+};
+
+bool inAirspace(int64_t x, int64_t y, int64_t z)
+{
+    return x >= 0 && x < AIRSPACE_X && y >= 0 && y < AIRSPACE_Y && z >= 0 && z < AIRSPACE_Z;
+}
+
+int64_t randomSpeed(Random &random)
+{
+    int64_t speed = random.uniform(MIN_SPEED, MAX_SPEED);
+    return (random.next() & 1) ? speed : -speed;
+}
+
+int64_t randomAltitude(Random &random, const Settings &settings)
+{
+    double total = settings.bands[0] + settings.bands[1] + settings.bands[2];
+    double pick = random.unit() * total;
+    int band = (pick < settings.bands[0]) ? 0 : (pick < settings.bands[0] + settings.bands[1]) ? 1 : 2;
+    return random.uniform(BAND_LIMITS[band], BAND_LIMITS[band + 1] - 1);
+}
+
+// Aircraft entering at a random position, with a random speed.
+ScenarioRecord randomAircraft(Random &random, const Settings &settings)
+{
+    ScenarioRecord aircraft = {};
+    aircraft.positionX = random.uniform(0, AIRSPACE_X - 1);
+    aircraft.positionY = random.uniform(0, AIRSPACE_Y - 1);
+    aircraft.positionZ = randomAltitude(random, settings);
+    aircraft.speedX = randomSpeed(random);
+    aircraft.speedY = randomSpeed(random);
+    aircraft.speedZ = random.uniform(-MAX_CLIMB, MAX_CLIMB);
+    return aircraft;
+}
+
+// Aircraft that will meet "other" inside the airspace, or false if no such aircraft could be placed.
+bool conflictingAircraft(Random &random, const ScenarioRecord &other, int32_t startTime, ScenarioRecord &aircraft)
+{
+    for (int attempt = 0; attempt < CONFLICT_ATTEMPTS; attempt++)
+    {
+        // Where the other aircraft will be when they meet.
+        int64_t conflictTime = random.uniform(MIN_CONFLICT_TIME, MAX_CONFLICT_TIME);
+        int64_t otherFlight = startTime + conflictTime - other.startTime;
+        int64_t meetX = int64_t(other.positionX) + int64_t(other.speedX) * otherFlight;
+        int64_t meetY = int64_t(other.positionY) + int64_t(other.speedY) * otherFlight;
+        int64_t meetZ = int64_t(other.positionZ) + int64_t(other.speedZ) * otherFlight;
+        if (!inAirspace(meetX, meetY, meetZ))
+        {
+            continue;
+        }
+
+        // Fly back from the meeting point to find where the new aircraft enters.
+        int64_t speedX = randomSpeed(random);
+        int64_t speedY = randomSpeed(random);
+        int64_t speedZ = random.uniform(-MAX_CLIMB, MAX_CLIMB);
+        int64_t x = meetX - speedX * conflictTime;
+        int64_t y = meetY - speedY * conflictTime;
+        int64_t z = meetZ - speedZ * conflictTime;
+        if (!inAirspace(x, y, z))
+        {
+            continue;
+        }
+
+        aircraft = {};
+        aircraft.positionX = x;
+        aircraft.positionY = y;
+        aircraft.positionZ = z;
+        aircraft.speedX = speedX;
+        aircraft.speedY = speedY;
+        aircraft.speedZ = speedZ;
+        return true;
+    }
+    return false;
+}
+
+vector<ScenarioRecord> generate(const Settings &settings)
+{
+    Random random(settings.seed);
+    vector<ScenarioRecord> scenario;
+    scenario.reserve(settings.count);
+
+    double arrival = 0; // Entry time of the last aircraft, in seconds
+    for (size_t i = 0; i < settings.count; i++)
+    {
+        // Gaps are uniform around the average, which keeps the generator free of library math.
+        arrival += random.unit() * 2.0 / settings.rate;
+        int32_t startTime = int32_t(arrival);
+
+        ScenarioRecord aircraft;
+        bool conflicting = !scenario.empty() && random.unit() < settings.conflicts &&
+                           conflictingAircraft(random, scenario[random.uniform(0, scenario.size() - 1)], startTime, aircraft);
+        if (!conflicting)
+        {
+            aircraft = randomAircraft(random, settings);
+        }
+
+        aircraft.aircraftID = int32_t(10000000 + i + 1); // 8-digit IDs, like the hand-written scenarios
+        aircraft.startTime = startTime;
+        scenario.push_back(aircraft);
+    }
+    return scenario;
+}
+
+void writeText(ostream &out, const vector<ScenarioRecord> &scenario)
+{
+    for (const ScenarioRecord &aircraft : scenario)
+    {
+        // Every value is a whole number, so the text is the same on every machine.
+        out << aircraft.aircraftID << " "
+            << int64_t(aircraft.positionX) << " " << int64_t(aircraft.positionY) << " " << int64_t(aircraft.positionZ) << " "
+            << int64_t(aircraft.speedX) << " " << int64_t(aircraft.speedY) << " " << int64_t(aircraft.speedZ) << " "
+            << aircraft.startTime << "\n";
+    }
+}
+
+void writeBinary(ostream &out, const vector<ScenarioRecord> &scenario)
+{
+    ScenarioHeader header = {SCENARIO_MAGIC, SCENARIO_VERSION, scenario.size()};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(scenario.data()), scenario.size() * sizeof(ScenarioRecord));
+}
+
+const char *GENERATOR_USAGE = "Usage: ScenarioGenerator [--seed N] [--count N] [--rate N] [--bands LOW,MID,HIGH] [--conflicts P] [--binary] [--output PATH]";
+
+int main(int argc, char *argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (option == "--binary")
+        { // the only option without a value
+            settings.binary = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            cerr << "Missing value for " << option << endl
+                 << GENERATOR_USAGE << endl;
+            return 1;
+        }
+
+        try
+        {
+            if (option == "--seed")
+            {
+                settings.seed = parseInteger(argv[++i], 0, numeric_limits<long>::max());
+            }
+            else if (option == "--count")
+            {
+                settings.count = parseInteger(argv[++i], 0, 89999999); // the number of 8-digit IDs
+            }
+            else if (option == "--rate")
+            {
+                settings.rate = parseNumber(argv[++i], 0.001, 1e6);
+            }
+            else if (option == "--conflicts")
+            {
+                settings.conflicts = parseNumber(argv[++i], 0, 1);
+            }
+            else if (option == "--output")
+            {
+                settings.output = argv[++i];
+            }
+            else if (option == "--bands")
+            {
+                string bands = argv[++i];
+                size_t first = bands.find(',');
+                size_t second = (first == string::npos) ? string::npos : bands.find(',', first + 1);
+                if (second == string::npos)
+                {
+                    throw invalid_argument(bands); // three weights, LOW,MID,HIGH
+                }
+                settings.bands[0] = parseNumber(bands.substr(0, first), 0, 1e6);
+                settings.bands[1] = parseNumber(bands.substr(first + 1, second - first - 1), 0, 1e6);
+                settings.bands[2] = parseNumber(bands.substr(second + 1), 0, 1e6);
+                if (settings.bands[0] + settings.bands[1] + settings.bands[2] <= 0)
+                {
+                    throw out_of_range(bands);
+                }
+            }
+            else
+            {
+                cerr << "Unknown option: " << option << endl
+                     << GENERATOR_USAGE << endl;
+                return 1;
+            }
+        }
+        catch (const logic_error &)
+        {
+            cerr << "Invalid value for " << option << ": " << argv[i] << endl
+                 << GENERATOR_USAGE << endl;
+            return 1;
+        }
+    }
+
+    vector<ScenarioRecord> scenario = generate(settings);
+
+    ofstream file;
+    if (!settings.output.empty())
+    {
+        file.open(settings.output, ios::out | ios::binary | ios::trunc);
+        if (!file)
+        {
+            perror(("Error opening " + settings.output).c_str());
+            return 1;
+        }
+    }
+    ostream &out = settings.output.empty() ? cout : file;
+
+    if (settings.binary)
+    {
+        writeBinary(out, scenario);
+    }
+    else
+    {
+        writeText(out, scenario);
+    }
+
+    cerr << "Generated " << scenario.size() << " aircrafts over " << (scenario.empty() ? 0 : scenario.back().startTime) << " seconds" << endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include "Random.h"
+#include "SpatialGrid.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: Compares the spatial grid broad phase of the separation check with the all-pairs loop it replaced.
+    For every aircraft count, that many aircrafts are placed at random in the airspace and checked both
+    ways. Both must find the same violations; the pairs tested and the time of a cycle are printed for each.
+
+    Usage: SeparationBenchmark [--seed N] [--counts N,N,...] [--rounds N]
+        --counts are the aircraft counts to check, 100,300,1000,3000,10000 by default.
+        --rounds is the number of cycles timed for every count, the fastest one is printed. */
+
+// Airspace bounds, the same as the Radar's
+const int64_t AIRSPACE_X = 100000;
+const int64_t AIRSPACE_Y = 100000;
+const int64_t AIRSPACE_Z = 40000;
+
+// Separation minima, the same as the Computer's
+const double HORIZONTAL_SEPARATION = 3000.0;
+const double VERTICAL_SEPARATION = 1000.0;
+
+struct CycleResult
+{
+    uint64_t pairsTested = 0;
+    uint64_t violations = 0;
+    double milliseconds = 0;
+};
+
+// Same test as Computer::violationCheck.
+bool violationCheck(Aircraft &a1, Aircraft &a2)
+{
+    double dx = abs(a1.getPositionX() - a2.getPositionX());
+    double dy = abs(a1.getPositionY() - a2.getPositionY());
+    double dz = abs(a1.getPositionZ() - a2.getPositionZ());
+
+    return (dx < HORIZONTAL_SEPARATION && dy < HORIZONTAL_SEPARATION && dz < VERTICAL_SEPARATION);
+}
+
+// Every pair of aircrafts, as the separation check did before the grid.
+CycleResult allPairsCycle(vector<Aircraft> &aircrafts)
+{
+    CycleResult result;
+    steady_clock::time_point start = steady_clock::now();
+    for (size_t i = 0; i < aircrafts.size(); i++)
+    {
+        for (size_t j = i + 1; j < aircrafts.size(); j++)
+        {
+            result.pairsTested++;
+            if (violationCheck(aircrafts[i], aircrafts[j]))
+            {
+                result.violations++;
+            }
+        }
+    }
+    result.milliseconds = duration<double, milli>(steady_clock::now() - start).count();
+    return result;
+}
+
+// Pairs in the same or neighbouring cells of the grid, the grid is built again in every cycle like in the Computer.
+CycleResult gridCycle(vector<Aircraft> &aircrafts, SpatialGrid &grid)
+{
+    CycleResult result;
+    steady_clock::time_point start = steady_clock::now();
+    grid.build(aircrafts);
+    grid.forEachCandidatePair([&](int i, int j)
+                              {
+        result.pairsTested++;
+        if (violationCheck(aircrafts[i], aircrafts[j]))
+        {
+            result.violations++;
+        } });
+    result.milliseconds = duration<double, milli>(steady_clock::now() - start).count();
+    return result;
+}
+
+// Runs a cycle the given number of times, and keeps the fastest one.
+template <typename Cycle>
+CycleResult fastestCycle(int rounds, Cycle cycle)
+{
+    CycleResult best = cycle();
+    for (int round = 1; round < rounds; round++)
+    {
+        CycleResult result = cycle();
+        if (result.milliseconds < best.milliseconds)
+        {
+            best = result;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = 1;
+    vector<size_t> counts = {100, 300, 1000, 3000, 10000};
+    int rounds = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (option == "--seed" && hasValue)
+        {
+            seed = stoull(argv[++i]);
+        }
+        else if (option == "--counts" && hasValue)
+        {
+            counts.clear();
+            string list = argv[++i];
+            for (size_t begin = 0; begin <= list.size();)
+            {
+                size_t end = list.find(',', begin);
+                end = (end == string::npos) ? list.size() : end;
+                counts.push_back(stoull(list.substr(begin, end - begin)));
+                begin = end + 1;
+            }
+        }
+        else if (option == "--rounds" && hasValue)
+        {
+            rounds = stoi(argv[++i]);
+        }
+        else
+        {
+            cerr << "Unknown option: " << option << endl;
+            return 1;
+        }
+    }
+    if (rounds <= 0)
+    {
+        cerr << "--rounds must be positive" << endl;
+        return 1;
+    }
+
+    cout << setw(9) << "aircrafts" << setw(14) << "all pairs" << setw(12) << "all ms"
+         << setw(14) << "grid pairs" << setw(12) << "grid ms" << setw(10) << "speedup" << setw(12) << "violations" << endl;
+
+    Random random(seed);
+    SpatialGrid grid(HORIZONTAL_SEPARATION, HORIZONTAL_SEPARATION, VERTICAL_SEPARATION);
+    bool mismatch = false;
+    for (size_t count : counts)
+    {
+        vector<Aircraft> aircrafts;
+        aircrafts.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            aircrafts.emplace_back(0, int(i + 1), random.uniform(0, AIRSPACE_X - 1), random.uniform(0, AIRSPACE_Y - 1), random.uniform(0, AIRSPACE_Z - 1),
+                                   0, 0, 0, false);
+        }
+
+        CycleResult allPairs = fastestCycle(rounds, [&]
+                                            { return allPairsCycle(aircrafts); });
+        CycleResult gridded = fastestCycle(rounds, [&]
+                                           { return gridCycle(aircrafts, grid); });
+
+        cout << setw(9) << count << setw(14) << allPairs.pairsTested << setw(12) << fixed << setprecision(3) << allPairs.milliseconds
+             << setw(14) << gridded.pairsTested << setw(12) << gridded.milliseconds
+             << setw(9) << setprecision(1) << (gridded.milliseconds > 0 ? allPairs.milliseconds / gridded.milliseconds : 0.0) << "x"
+             << setw(12) << gridded.violations << endl;
+
+        if (allPairs.violations != gridded.violations)
+        {
+            cerr << "Mismatch at " << count << " aircrafts: " << allPairs.violations << " violations for all pairs, "
+                 << gridded.violations << " for the grid" << endl;
+            mismatch = true;
+        }
+    }
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+/*NOTE: State that outlives the code that uses it. The atomics in the shared memory segments are used by
+    several processes, which only works when they are lock-free: the lock of any other atomic would only
+    be held in the address space of one process. The globals of a subsystem, its console output and its
+    metrics, are never destroyed, since the other threads may still use them while main() returns and
+    the static destructors run. */
+
+static_assert(atomic<uint32_t>::is_always_lock_free && atomic<uint64_t>::is_always_lock_free,
+              "the atomics in shared memory must be lock-free to be shared between processes");
+
+// Creates a global of the subsystem, which is never destroyed.
+template <typename T>
+T &makeGlobal()
+{
+    return *new T();
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SharedState.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/*NOTE: The simulation clock ("/atc_clock") is the time of the airspace, driven by the Radar. The Radar
+    advances it by one step every time it moves the aircrafts, in real time or at a multiple of real
+    time. The periodic tasks of the Computer and the Visual
+    Display sleep on this clock instead of the wall clock, so a long scenario can be played in
+    seconds. While the Radar is not driving the clock, it falls back to the wall clock; a Radar that was
+    killed before it could stop the clock is found by its process id. */
+
+const char *SIM_CLOCK_NAME = "/atc_clock";
+const uint32_t SIM_CLOCK_MAGIC = 0x4B4C4353; // "SCLK"
+const uint32_t SIM_CLOCK_VERSION = 2;
+
+struct SimClockData
+{
+    uint32_t magic;
+    uint32_t version;
+    double multiplier;            // Simulated seconds per real second, always positive.
+    atomic<uint64_t> nanoseconds; // Simulated time since the Radar started.
+    atomic<uint32_t> running;     // 1 while the Radar drives the clock.
+    pid_t owner;                  // Process id of the Radar driving the clock.
+};
+
+class SimClock
+{
+public:
+    // Constructor, creates the shared memory if the Radar has not done it yet
+    SimClock()
+    {
+        localStart = steady_clock::now();
+
+        fd = shm_open(SIM_CLOCK_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd == -1)
+        {
+            perror("shm_open() for the simulation clock failed");
+            exit(1);
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) == -1 || (size_t(status.st_size) < sizeof(SimClockData) && ftruncate(fd, sizeof(SimClockData)) == -1))
+        {
+            perror("ftruncate() for the simulation clock failed");
+            exit(1);
+        }
+
+        data = static_cast<SimClockData *>(mmap(0, sizeof(SimClockData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        if (data == MAP_FAILED)
+        {
+            perror("mmap() for the simulation clock failed");
+            exit(1);
+        }
+    }
+
+    // Destructor
+    ~SimClock()
+    {
+        munmap(data, sizeof(SimClockData));
+        close(fd);
+    }
+
+    // Called by the Radar when it starts driving the clock.
+    void start(double multiplier)
+    {
+        data->running.store(0);
+        data->magic = SIM_CLOCK_MAGIC;
+        data->version = SIM_CLOCK_VERSION;
+        data->multiplier = multiplier;
+        data->owner = getpid();
+        data->nanoseconds.store(0);
+        data->running.store(1, memory_order_release);
+    }
+
+    // Called by the Radar after every step.
+    void advance(uint64_t nanoseconds)
+    {
+        data->nanoseconds.store(nanoseconds, memory_order_release);
+    }
+
+    // Called by the Radar when it stops, the other subsystems go back to the wall clock.
+    void stop()
+    {
+        data->running.store(0, memory_order_release);
+    }
+
+    bool isRunning() const
+    {
+        return data->running.load(memory_order_acquire) == 1 && data->magic == SIM_CLOCK_MAGIC && data->version == SIM_CLOCK_VERSION &&
+               data->owner > 0 && (kill(data->owner, 0) == 0 || errno == EPERM); // EPERM: alive, under another user
+    }
+
+    // Current time, in seconds.
+    double now() const
+    {
+        if (isRunning())
+        {
+            return data->nanoseconds.load(memory_order_acquire) * 1e-9;
+        }
+        return duration<double>(steady_clock::now() - localStart).count();
+    }
+
+    // Simulated seconds per real second.
+    double getMultiplier() const
+    {
+        return isRunning() ? data->multiplier : 1.0;
+    }
+
+    // Real time to wait for the clock to advance by the given number of seconds.
+    duration<double> realDelay(double seconds) const
+    {
+        return duration<double>(max(seconds, 0.0) / getMultiplier());
+    }
+
+    // Sleeps until the clock has advanced by the given number of seconds.
+    void sleepFor(double seconds) const
+    {
+        double start = now();
+        while (true)
+        {
+            double current = now();
+            if (current < start)
+            {
+                start = current; // The Radar started driving the clock, which went back to 0.
+            }
+
+            double left = start + seconds - current;
+            if (left <= 0)
+            {
+                return;
+            }
+            this_thread::sleep_for(realDelay(left));
+        }
+    }
+
+private:
+    int fd;
+    SimClockData *data;
+    steady_clock::time_point localStart; // Origin of the wall clock used while the Radar is not running.
+};
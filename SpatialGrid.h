@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include "Aircraft.h"
+
+using namespace std;
+
+/*NOTE: The spatial grid is the broad phase of the separation check.
+    The airspace is divided into cells the size of the separation minima, so two aircrafts
+    that are closer than the minima are always in the same cell or in neighbouring cells. */
+
+class SpatialGrid
+{
+public:
+    // Constructor
+    SpatialGrid(double cellX, double cellY, double cellZ)
+    {
+        cellSizeX = cellX;
+        cellSizeY = cellY;
+        cellSizeZ = cellZ;
+    }
+
+    // Places every aircraft in its cell. Must be called before the candidate pairs are visited.
+    void build(vector<Aircraft> &aircrafts)
+    {
+        entries.clear();
+        cells.clear();
+        entries.reserve(aircrafts.size());
+
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            Aircraft &aircraft = aircrafts[i];
+            entries.push_back({cellKey(cellIndex(aircraft.getPositionX(), cellSizeX),
+                                       cellIndex(aircraft.getPositionY(), cellSizeY),
+                                       cellIndex(aircraft.getPositionZ(), cellSizeZ)),
+                               static_cast<int>(i)});
+        }
+
+        // Sort the aircrafts by cell so that every cell is a contiguous range of entries.
+        sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+             { return a.key < b.key || (a.key == b.key && a.index < b.index); });
+
+        size_t begin = 0;
+        while (begin < entries.size())
+        {
+            size_t end = begin + 1;
+            while (end < entries.size() && entries[end].key == entries[begin].key)
+            {
+                end++;
+            }
+            cells[entries[begin].key] = {begin, end};
+            begin = end;
+        }
+    }
+
+    // Calls visit(i, j) exactly once for every pair of aircrafts in the same or neighbouring cells, with i < j.
+    template <typename Visitor>
+    void forEachCandidatePair(Visitor visit) const
+    {
+        for (const auto &cell : cells)
+        {
+            uint64_t key = cell.first;
+            size_t begin = cell.second.first;
+            size_t end = cell.second.second;
+
+            // Pairs inside the cell itself.
+            for (size_t a = begin; a < end; a++)
+            {
+                for (size_t b = a + 1; b < end; b++)
+                {
+                    visit(entries[a].index, entries[b].index);
+                }
+            }
+
+            // Pairs with the 13 "forward" neighbours, so every neighbouring pair of cells is only visited once.
+            for (int n = 0; n < 13; n++)
+            {
+                auto neighbour = cells.find(key + neighbourOffset(n));
+                if (neighbour == cells.end())
+                {
+                    continue;
+                }
+
+                for (size_t a = begin; a < end; a++)
+                {
+                    for (size_t b = neighbour->second.first; b < neighbour->second.second; b++)
+                    {
+                        int i = entries[a].index;
+                        int j = entries[b].index;
+                        visit(min(i, j), max(i, j));
+                    }
+                }
+            }
+        }
+    }
+
+    size_t getOccupiedCells() const
+    {
+        return cells.size();
+    }
+
+private:
+    // Each cell coordinate is stored with a bias in 21 bits of the key.
+    static const int COORDINATE_BITS = 21;
+    static const int64_t COORDINATE_BIAS = int64_t(1) << (COORDINATE_BITS - 1);
+
+    struct Entry
+    {
+        uint64_t key; // Key of the cell containing the aircraft.
+        int index;    // Index of the aircraft in the aircrafts vector.
+    };
+
+    int64_t cellIndex(double position, double cellSize) const
+    {
+        return static_cast<int64_t>(floor(position / cellSize));
+    }
+
+    static uint64_t cellKey(int64_t ix, int64_t iy, int64_t iz)
+    {
+        return (uint64_t(ix + COORDINATE_BIAS) << (2 * COORDINATE_BITS)) |
+               (uint64_t(iy + COORDINATE_BIAS) << COORDINATE_BITS) |
+               uint64_t(iz + COORDINATE_BIAS);
+    }
+
+    // Offset to add to a key to reach one of the 13 neighbours that come after it in key order.
+    static uint64_t neighbourOffset(int n)
+    {
+        static const int offsets[13][3] = {
+            {0, 0, 1},
+            {0, 1, -1}, {0, 1, 0}, {0, 1, 1},
+            {1, -1, -1}, {1, -1, 0}, {1, -1, 1},
+            {1, 0, -1}, {1, 0, 0}, {1, 0, 1},
+            {1, 1, -1}, {1, 1, 0}, {1, 1, 1}};
+
+        return cellKey(offsets[n][0], offsets[n][1], offsets[n][2]) - cellKey(0, 0, 0);
+    }
+
+    double cellSizeX;
+    double cellSizeY;
+    double cellSizeZ;
+    vector<Entry> entries;                               // Aircrafts sorted by cell.
+    unordered_map<uint64_t, pair<size_t, size_t>> cells; // Range of entries held by each occupied cell.
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "Aircraft.h"
+
+using namespace std;
+
+/*NOTE: Sweep and prune is the broad phase of the collision check.
+    Every aircraft is given the box it sweeps over the look-ahead window, grown by half of the
+    separation minima on each side. Two aircrafts can only come closer than the minima inside the
+    window if their boxes overlap, so only those pairs need to be solved exactly. */
+
+class SweepAndPrune
+{
+public:
+    // Constructor
+    SweepAndPrune(double window, double horizontalMargin, double verticalMargin)
+    {
+        lookahead = window;
+        margins[0] = horizontalMargin;
+        margins[1] = horizontalMargin;
+        margins[2] = verticalMargin;
+        axis = 0;
+    }
+
+    // Computes the swept box of every aircraft and sorts the boxes along the dominant axis.
+    void build(vector<Aircraft> &aircrafts)
+    {
+        boxes.clear();
+        boxes.reserve(aircrafts.size());
+
+        double sum[3] = {0, 0, 0};
+        double sumSquares[3] = {0, 0, 0};
+
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            Aircraft &aircraft = aircrafts[i];
+            double position[3] = {aircraft.getPositionX(), aircraft.getPositionY(), aircraft.getPositionZ()};
+            double speed[3] = {aircraft.getSpeedX(), aircraft.getSpeedY(), aircraft.getSpeedZ()};
+
+            Box box;
+            box.index = static_cast<int>(i);
+            for (int k = 0; k < 3; k++)
+            {
+                double end = position[k] + speed[k] * lookahead;
+                box.min[k] = min(position[k], end) - margins[k] - TOLERANCE;
+                box.max[k] = max(position[k], end) + margins[k] + TOLERANCE;
+
+                double centre = (box.min[k] + box.max[k]) / 2;
+                sum[k] += centre;
+                sumSquares[k] += centre * centre;
+            }
+            boxes.push_back(box);
+        }
+
+        // Sweep along the axis on which the boxes are the most spread out, since it prunes the most pairs.
+        axis = 0;
+        double bestVariance = -1;
+        for (int k = 0; k < 3 && !boxes.empty(); k++)
+        {
+            double mean = sum[k] / boxes.size();
+            double variance = sumSquares[k] / boxes.size() - mean * mean;
+            if (variance > bestVariance)
+            {
+                bestVariance = variance;
+                axis = k;
+            }
+        }
+
+        int sortAxis = axis;
+        sort(boxes.begin(), boxes.end(), [sortAxis](const Box &a, const Box &b)
+             { return a.min[sortAxis] < b.min[sortAxis]; });
+    }
+
+    // Calls visit(i, j) exactly once for every pair of aircrafts whose swept boxes overlap, with i < j.
+    template <typename Visitor>
+    void forEachCandidatePair(Visitor visit) const
+    {
+        for (size_t a = 0; a < boxes.size(); a++)
+        {
+            const Box &first = boxes[a];
+
+            // Boxes are sorted by their start along the axis, so the sweep stops at the first box that starts after this one ends.
+            for (size_t b = a + 1; b < boxes.size() && boxes[b].min[axis] <= first.max[axis]; b++)
+            {
+                const Box &second = boxes[b];
+                if (overlaps(first, second))
+                {
+                    visit(min(first.index, second.index), max(first.index, second.index));
+                }
+            }
+        }
+    }
+
+    int getAxis() const
+    {
+        return axis;
+    }
+
+private:
+    static constexpr double TOLERANCE = 1.0; // Absorbs rounding differences with the exact collision solver.
+
+    struct Box
+    {
+        double min[3];
+        double max[3];
+        int index; // Index of the aircraft in the aircrafts vector.
+    };
+
+    static bool overlaps(const Box &a, const Box &b)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            if (a.max[k] < b.min[k] || b.max[k] < a.min[k])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double lookahead;
+    double margins[3];
+    int axis;          // Axis the boxes are sorted and swept along.
+    vector<Box> boxes; // Swept boxes sorted along the axis.
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <csignal>
+#include <pthread.h>
+#include "Doorbell.h"
+#include "SharedState.h"
+
+using namespace std;
+
+/*NOTE: Timing of the periodic tasks of a subsystem. Every task records the execution time of its runs,
+    their release jitter (how late a run started compared to when it was due) and its deadline misses.
+    The times go into histograms with logarithmic buckets, each split into 32 linear sub-buckets, so
+    any value is kept within about 3% at a fixed cost and a run is recorded with a few relaxed atomic
+    increments, without a lock.
+
+    The latency of the commands reaching the subsystem, on every hop of their path, is kept the same way.
+
+    The figures are printed on demand: "kill -USR1 <pid>" prints the median, 99th percentile and
+    maximum of every task and hop of the subsystem. installTaskMetricsSignal() must be called at the start of
+    main(), before any other thread is started, so SIGUSR1 is only taken by the thread that prints. */
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : count(0), longest(0)
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, memory_order_relaxed);
+        }
+    }
+
+    // Records a value, in nanoseconds.
+    void record(uint64_t value)
+    {
+        buckets[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+        count.fetch_add(1, memory_order_relaxed);
+        uint64_t previous = longest.load(memory_order_relaxed);
+        while (value > previous && !longest.compare_exchange_weak(previous, value, memory_order_relaxed))
+            ;
+    }
+
+    uint64_t getCount() const
+    {
+        return count.load(memory_order_relaxed);
+    }
+
+    uint64_t getMax() const
+    {
+        return longest.load(memory_order_relaxed);
+    }
+
+    // Smallest value that at least the given fraction of the values do not exceed, within the precision of
+    // the buckets. 0 if nothing was recorded.
+    uint64_t percentile(double fraction) const
+    {
+        uint64_t total = 0;
+        uint64_t counts[BUCKETS];
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            counts[i] = buckets[i].load(memory_order_relaxed);
+            total += counts[i];
+        }
+
+        uint64_t rank = uint64_t(fraction * total + 0.5);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            seen += counts[i];
+            if (counts[i] > 0 && seen >= max(rank, uint64_t(1)))
+            {
+                return min(highestValueOf(i), getMax());
+            }
+        }
+        return getMax();
+    }
+
+private:
+    static const unsigned SUB_BUCKET_BITS = 5; // 32 linear sub-buckets per power of two
+    static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const unsigned MAX_EXPONENT = 42; // About 73 minutes in nanoseconds, longer values go to the last bucket
+    static const size_t BUCKETS = SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 2);
+
+    static size_t bucketOf(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return value;
+        }
+        unsigned exponent = 63 - __builtin_clzll(value);
+        if (exponent > MAX_EXPONENT)
+        {
+            return BUCKETS - 1;
+        }
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        return SUB_BUCKETS * (shift + 1) + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    static uint64_t highestValueOf(size_t bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+        {
+            return bucket;
+        }
+        unsigned shift = bucket / SUB_BUCKETS - 1;
+        uint64_t lowest = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lowest + (uint64_t(1) << shift) - 1;
+    }
+
+    atomic<uint64_t> buckets[BUCKETS];
+    atomic<uint64_t> count;
+    atomic<uint64_t> longest;
+};
+
+class TaskMetrics
+{
+public:
+    // A deadline of 0 means the task has none, or checks it itself.
+    TaskMetrics(const string &name, uint64_t deadline) : name(name), deadline(deadline), misses(0), skipped(0) {}
+
+    // Records a run, all times in nanoseconds.
+    void recordRun(uint64_t jitter, uint64_t executionTime, bool missed)
+    {
+        jitters.record(jitter);
+        executionTimes.record(executionTime);
+        if (missed)
+        {
+            misses.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Records releases that did not run, because the previous run was still going.
+    void recordSkipped(uint64_t releases)
+    {
+        skipped.fetch_add(releases, memory_order_relaxed);
+    }
+
+    const string &getName() const
+    {
+        return name;
+    }
+
+    uint64_t getDeadline() const
+    {
+        return deadline;
+    }
+
+    // One line with the percentiles of the task, in milliseconds.
+    string summary() const
+    {
+        stringstream line;
+        line << fixed << setprecision(3) << "Task " << name << ": " << executionTimes.getCount() << " runs"
+             << ", execution p50 " << executionTimes.percentile(0.5) / 1e6 << " ms p99 " << executionTimes.percentile(0.99) / 1e6
+             << " ms max " << executionTimes.getMax() / 1e6 << " ms"
+             << ", jitter p50 " << jitters.percentile(0.5) / 1e6 << " ms p99 " << jitters.percentile(0.99) / 1e6
+             << " ms max " << jitters.getMax() / 1e6 << " ms"
+             << ", " << misses.load(memory_order_relaxed) << " deadline misses, " << skipped.load(memory_order_relaxed) << " skipped";
+        return line.str();
+    }
+
+private:
+    string name;
+    uint64_t deadline; // Nanoseconds from the release
+    LatencyHistogram executionTimes;
+    LatencyHistogram jitters;
+    atomic<uint64_t> misses;
+    atomic<uint64_t> skipped;
+};
+
+// Times one run of a task, from its construction to its destruction, on CLOCK_MONOTONIC. The jitter is how
+// late the run started, given by the caller in nanoseconds. When the task has a deadline, the run misses it if
+// the jitter and the execution time add up to more.
+class ScopedTaskTimer
+{
+public:
+    ScopedTaskTimer(TaskMetrics &task, uint64_t jitter = 0) : task(task), jitter(jitter), missed(false), start(monotonicNanoseconds()) {}
+
+    ~ScopedTaskTimer()
+    {
+        uint64_t executionTime = monotonicNanoseconds() - start;
+        if (task.getDeadline() > 0 && jitter + executionTime > task.getDeadline())
+        {
+            missed = true;
+        }
+        task.recordRun(jitter, executionTime, missed);
+    }
+
+    // Called by a task that checks its deadline itself.
+    void missedDeadline()
+    {
+        missed = true;
+    }
+
+private:
+    TaskMetrics &task;
+    uint64_t jitter;
+    bool missed;
+    uint64_t start;
+};
+
+// Latency of the commands on one hop, from the monotonic time at which the previous subsystem sent them.
+class HopLatency
+{
+public:
+    HopLatency(const string &hop) : hop(hop) {}
+
+    // Records a command sent at the given monotonic time, a time of 0 means the sender did not stamp it.
+    void record(uint64_t sentAt)
+    {
+        if (sentAt == 0)
+        {
+            return;
+        }
+        uint64_t now = monotonicNanoseconds();
+        latencies.record((now > sentAt) ? now - sentAt : 0);
+    }
+
+    // One line with the percentiles of the hop, in microseconds.
+    string summary() const
+    {
+        stringstream line;
+        line << fixed << setprecision(1) << "Hop " << hop << ": " << latencies.getCount() << " commands"
+             << ", latency p50 " << latencies.percentile(0.5) / 1e3 << " us p99 " << latencies.percentile(0.99) / 1e3
+             << " us max " << latencies.getMax() / 1e3 << " us";
+        return line.str();
+    }
+
+private:
+    string hop;
+    LatencyHistogram latencies;
+};
+
+class TaskMetricsRegistry
+{
+public:
+    // Adds a task, the returned metrics last as long as the subsystem. The deadline is in seconds, 0 for none.
+    TaskMetrics &add(const string &name, double deadline = 0)
+    {
+        lock_guard<mutex> lock(registryMutex);
+        tasks.emplace_back(name, uint64_t(deadline * 1e9));
+        return tasks.back();
+    }
+
+    // Adds a hop of the commands, the returned latency lasts as long as the subsystem.
+    HopLatency &addHop(const string &hop)
+    {
+        lock_guard<mutex> lock(registryMutex);
+        hops.emplace_back(hop);
+        return hops.back();
+    }
+
+    // Prints one line per task, then one per hop.
+    void print(ostream &out)
+    {
+        string lines;
+        {
+            lock_guard<mutex> lock(registryMutex);
+            for (const TaskMetrics &task : tasks)
+            {
+                lines += task.summary() + "\n";
+            }
+            for (const HopLatency &hop : hops)
+            {
+                lines += hop.summary() + "\n";
+            }
+        }
+        out << lines << flush;
+    }
+
+private:
+    deque<TaskMetrics> tasks; // A deque, so the metrics never move once added
+    deque<HopLatency> hops;
+    mutex registryMutex;
+};
+
+// Tasks of the subsystem.
+TaskMetricsRegistry &taskMetrics = makeGlobal<TaskMetricsRegistry>();
+
+// Prints the metrics of every task on SIGUSR1, from a thread of its own. Must be called before any other thread
+// is started, they inherit the blocked signal.
+inline void installTaskMetricsSignal()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    thread([signals]
+           {
+        int signal;
+        while (sigwait(&signals, &signal) == 0)
+        {
+            taskMetrics.print(cout);
+        } })
+        .detach();
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include "Aircraft.h"
+#include "RadarData.h"
+
+using namespace std;
+
+/*NOTE: Tracks of the Computer, kept from one radar update to the next. A track is updated in place when
+    its aircraft moves or changes speed, added when an aircraft enters the airspace and removed when it
+    leaves, so the state of a track, such as its violation flag, lasts as long as the aircraft.
+
+    Every batch of changes gets the next generation of the store, and every track remembers the generation
+    in which it last changed. A consumer that has seen generation N asks for the tracks changed since N,
+    and for the aircrafts that left since N. The aircrafts that left are only remembered for a limited
+    number of generations; a consumer further behind is told to read every track again.
+
+    The tracks are kept densely in a vector, in no particular order, so the conflict checks index them
+    like before. Removing a track moves the last one into its place. */
+
+class TrackStore
+{
+public:
+    // Number of generations for which the aircrafts that left are remembered.
+    static const uint64_t REMOVAL_HISTORY = 64;
+
+    TrackStore() : generation(0), horizon(0), lastRadarGeneration(UINT64_MAX), updates(0) {}
+
+    vector<Aircraft> &getAircrafts()
+    {
+        return aircrafts;
+    }
+
+    // Generation of the last change to the tracks.
+    uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
+    // Generation in which the track at the given index last changed.
+    uint64_t getTrackGeneration(size_t index) const
+    {
+        return trackGenerations[index];
+    }
+
+    // Applies a copy of the radar table taken at the given radar generation. Returns false, without
+    // touching the tracks, if the radar has not changed since the last update.
+    bool update(const vector<SharedAircraft> &radarAircrafts, uint64_t radarGeneration)
+    {
+        if (radarGeneration == lastRadarGeneration)
+        {
+            return false;
+        }
+        lastRadarGeneration = radarGeneration;
+        updates++;
+
+        uint64_t next = generation + 1;
+        bool changed = false;
+
+        for (const SharedAircraft &radarAircraft : radarAircrafts)
+        {
+            auto found = indexOf.find(radarAircraft.aircraftID);
+            if (found == indexOf.end())
+            {
+                indexOf[radarAircraft.aircraftID] = aircrafts.size();
+                aircrafts.emplace_back(radarAircraft.startTime, radarAircraft.aircraftID,
+                                       radarAircraft.positionX, radarAircraft.positionY, radarAircraft.positionZ,
+                                       radarAircraft.speedX, radarAircraft.speedY, radarAircraft.speedZ, false);
+                trackGenerations.push_back(next);
+                lastSeen.push_back(updates);
+                changed = true;
+                continue;
+            }
+
+            size_t i = found->second;
+            lastSeen[i] = updates;
+            Aircraft &aircraft = aircrafts[i];
+            if (aircraft.getPositionX() != radarAircraft.positionX || aircraft.getPositionY() != radarAircraft.positionY ||
+                aircraft.getPositionZ() != radarAircraft.positionZ || aircraft.getSpeedX() != radarAircraft.speedX ||
+                aircraft.getSpeedY() != radarAircraft.speedY || aircraft.getSpeedZ() != radarAircraft.speedZ)
+            {
+                aircraft.setPositionX(radarAircraft.positionX);
+                aircraft.setPositionY(radarAircraft.positionY);
+                aircraft.setPositionZ(radarAircraft.positionZ);
+                aircraft.setSpeedX(radarAircraft.speedX);
+                aircraft.setSpeedY(radarAircraft.speedY);
+                aircraft.setSpeedZ(radarAircraft.speedZ);
+                trackGenerations[i] = next;
+                changed = true;
+            }
+        }
+
+        // The tracks that were not in the copy have left the airspace. Backwards, so the track moved into
+        // position i by a removal was already checked.
+        for (size_t i = aircrafts.size(); i-- > 0;)
+        {
+            if (lastSeen[i] != updates)
+            {
+                removed.push_back({next, aircrafts[i].getAircraftID()});
+                remove(i);
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            generation = next;
+            forgetOldRemovals();
+        }
+        return changed;
+    }
+
+    // Clears the violation flags before a scan sets them again.
+    void beginViolationScan()
+    {
+        previousViolations.resize(aircrafts.size());
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            previousViolations[i] = aircrafts[i].getIsViolation();
+            aircrafts[i].setIsViolation(false);
+        }
+    }
+
+    // Gives the tracks whose violation flag changed during the scan a new generation.
+    void endViolationScan()
+    {
+        uint64_t next = generation + 1;
+        bool changed = false;
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            if (aircrafts[i].getIsViolation() != bool(previousViolations[i]))
+            {
+                trackGenerations[i] = next;
+                changed = true;
+            }
+        }
+        if (changed)
+        {
+            generation = next;
+        }
+    }
+
+    // Lists the indices of the tracks changed after the given generation, and the IDs of the aircrafts that
+    // left after it. Returns false if the generation is too old to know which aircrafts left, the consumer
+    // must then read every track again.
+    bool changedSince(uint64_t since, vector<size_t> &changedTracks, vector<int> &removedIDs) const
+    {
+        changedTracks.clear();
+        removedIDs.clear();
+        if (since < horizon)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < aircrafts.size(); i++)
+        {
+            if (trackGenerations[i] > since)
+            {
+                changedTracks.push_back(i);
+            }
+        }
+        for (const Removal &removal : removed)
+        {
+            if (removal.generation > since)
+            {
+                removedIDs.push_back(removal.aircraftID);
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Removal
+    {
+        uint64_t generation;
+        int aircraftID;
+    };
+
+    void remove(size_t i)
+    {
+        size_t last = aircrafts.size() - 1;
+        indexOf.erase(aircrafts[i].getAircraftID());
+        if (i != last)
+        {
+            aircrafts[i] = aircrafts[last];
+            trackGenerations[i] = trackGenerations[last];
+            lastSeen[i] = lastSeen[last];
+            indexOf[aircrafts[i].getAircraftID()] = i;
+        }
+        aircrafts.pop_back();
+        trackGenerations.pop_back();
+        lastSeen.pop_back();
+    }
+
+    void forgetOldRemovals()
+    {
+        while (!removed.empty() && removed.front().generation + REMOVAL_HISTORY <= generation)
+        {
+            horizon = removed.front().generation; // A consumer at an older generation may have missed this removal
+            removed.pop_front();
+        }
+    }
+
+    vector<Aircraft> aircrafts;
+    vector<uint64_t> trackGenerations; // Generation in which every track last changed
+    vector<uint64_t> lastSeen;         // Last update in which every track was in the radar table
+    unordered_map<int, size_t> indexOf; // Index of every track, by aircraft ID
+    deque<Removal> removed;             // Aircrafts that left, oldest first
+    vector<uint8_t> previousViolations; // Violation flags before the current scan
+
+    uint64_t generation;
+    uint64_t horizon;             // Oldest generation for which changedSince() can list the aircrafts that left
+    uint64_t lastRadarGeneration; // Radar generation of the last update
+    uint64_t updates;             // Number of updates applied
+};
@@ -16,6 +16,13 @@
 #include <thread>      // For "this_thread::sleep_for()".
 #include <atomic>      // Used to synchronize all threads for termination.
 #include <unistd.h>    // Used to allow the threads to sleep; Used for alarm().
+#include <iomanip>     // Used to format the alert timestamps.
+#include <map>         // Used to keep a copy of the tracks.
+#include <mutex>       // Used to replace the data semaphore while the threads run.
+#include "DisplayData.h"
+#include "SimClock.h" // Used to follow the time of the simulation.
+#include "TaskMetrics.h" // Used to record the timing of the threads.
+#include "Metrics.h"     // Used to publish the activity of the display.
 
 using namespace std;
 using namespace std::chrono;
@@ -27,6 +34,7 @@ const int columns = 100;                // Number of columns in the airspace gri
 bool augmentedAircraftsPresent = false; // Indicates if any augmented information was requested by the operator.
 bool violationsPresent = false;         // Indicates if any violations have been detected.
 atomic<bool> *terminateNow;             // Indicates if the subsystem should be terminating.
+SimClock *simClock;                     // Time of the airspace, driven by the Radar; the display refreshes on it.
 
 const char *SHARED_MEMORY_AIRCRAFT_DATA = "/AircraftData";   // Name for the shared memory used to store all the regular aircrafts.
 const char *SHARED_MEMORY_AUGMENTED_DATA = "/AugmentedData"; // Name for the shared memory used to store all the augmented aircrafts.
@@ -36,21 +44,41 @@ const char *SEMAPHORE_DATA = "/data_semaphore";              // Name for the sem
 const char *SHARED_MEMORY_TERMINATION = "/shm_term";   // Name for the shared memory used to terminate the system.
 const char *SEMAPHORE_TERMINATION = "/term_semaphore"; // Name for the semaphore used to synchronize all processes for the termination of the RTOS.
 
+const double DISPLAY_PERIOD = 5.0; // Period of the data and violation handling threads, in seconds of the simulation clock.
+
 // Containers for different aircraft data.
-vector<array<string, 5>> regularAircraftData;   // Holds the current regular aircraft data.
+vector<TrackRecord> regularAircraftData;        // Holds the current regular aircraft data.
 vector<array<string, 8>> augmentedAircraftData; // Holds the current augmented aircraft data.
 vector<tuple<int, int>> aircraftGridPositions;  // Holds the positions of the aircrafts in the visual display.
 vector<string> violations;                      // Holds a list of violations, both present and future.
+uint64_t lastAlertSequence = 0;                 // Sequence number of the last alert that was printed.
+size_t regularDataSize = 0;                     // Size of the shared memory for the regular aircrafts, read from its header.
+mutex dataMutex;                                // Held around the data semaphore, so the data thread can replace it.
+
+// Copy of the tracks, kept up to date from the deltas published by the Computer.
+map<int, TrackRecord> trackCopy; // Tracks by aircraft ID.
+uint64_t deltaCursor = 0;        // Sequence of the last delta applied to the copy.
+bool tracksSynced = false;       // False until the copy is made from a keyframe.
+uint64_t appliedDeltas = 0;      // Number of deltas applied to the copy.
+uint64_t keyframeResyncs = 0;    // Number of times the copy was made again from a keyframe.
 
 // Function Prototypes
 void insertBanner(string title);
 string getCurrentTimestamp();
 template <size_t arraySize> // Allows the following function to work with different-sized arrays.
 vector<tuple<int, int>> calculateAirspacePositions(vector<tuple<int, int>> currentPositions, vector<array<string, arraySize>> newAircrafts);
-void drawAirspace(vector<array<string, 5>> regularAircrafts, vector<array<string, 8>> augmentedAricrafts, vector<tuple<int, int>> gridPositions);
+vector<tuple<int, int>> calculateAirspacePositions(vector<tuple<int, int>> currentPositions, const vector<TrackRecord> &newAircrafts);
+tuple<int, int> airspaceGridPosition(float xPosition, float yPosition);
+void drawAirspace(const vector<TrackRecord> &regularAircrafts, vector<array<string, 8>> augmentedAricrafts, vector<tuple<int, int>> gridPositions);
 void *aircraftDataHandling(void *arg); // This function will be ran by the thread to print the regular visual display.
 void *violationHandling(void *arg);    // This function will be ran by the thread to print the violations.
 void *terminationHandling(void *arg);  // This function will be ran by the thread to terminate the system.
+string formatAlert(const Alert &alert);
+string formatTrack(const TrackRecord &track);
+void applyTrackDelta(const TrackDelta &delta);
+void updateTrackCopy(void *segment);
+void lockData(sem_t *semaphore);
+void *mapTracks(int fd, size_t &size, const char *&error);
 
 // Struct to pass arguments to threads
 struct ThreadParameters
@@ -75,14 +103,21 @@ struct ThreadParameters
     atomic<bool> *terminateNow;
 };
 
+void reopenTracks(ThreadParameters *args);
+
 int main()
 {
+    // The timing of the threads is printed with "kill -USR1", before any thread is started.
+    installTaskMetricsSignal();
+    systemMetrics.open();
+
     // Initial greeting message.
     cout << "Welcome to the Visual Display Subsystem!" << endl
          << "Information regarding aircrafts will appear below..." << endl;
 
     /* START SETUP*/
     terminateNow = new atomic<bool>(false);
+    simClock = new SimClock();
 
     // Data
     // Regular Aircrafts
@@ -94,10 +129,11 @@ int main()
     }
 
     // Mapping the shared memory into the Visual Display's address space.
-    void *shm_ptr_reg = mmap(0, SHM_SIZE, PROT_READ, MAP_SHARED, shm_fd_reg, 0);
-    if (shm_ptr_reg == MAP_FAILED)
+    const char *mappingError;
+    void *shm_ptr_reg = mapTracks(shm_fd_reg, regularDataSize, mappingError);
+    if (shm_ptr_reg == nullptr)
     {
-        cerr << "Shared Memory Mapping for the augmented aircrafts failed..." << endl;
+        cerr << mappingError << endl;
         return -1;
     }
 
@@ -126,7 +162,7 @@ int main()
     }
 
     // Mapping the shared memory into the Visual Display's address space.
-    void *shm_ptr_viol = mmap(0, SHM_SIZE, PROT_READ, MAP_SHARED, shm_fd_viol, 0);
+    void *shm_ptr_viol = mmap(0, ALERTS_SHM_SIZE, PROT_READ, MAP_SHARED, shm_fd_viol, 0);
     if (shm_ptr_viol == MAP_FAILED)
     {
         cerr << "Shared Memory Mapping for the violations failed..." << endl;
@@ -216,8 +252,8 @@ int main()
     pthread_join(thread_term, NULL);
 
     /* START CLEANUP */
-    // Close the data semaphore.
-    if (sem_close(sem_data) == -1)
+    // Close the data semaphore, which the data thread replaces when the Computer restarts.
+    if (sem_close(parameters.sem_data) == -1)
     {
         perror("sem_close() for all data failed");
         return false;
@@ -270,48 +306,49 @@ vector<tuple<int, int>> calculateAirspacePositions(vector<tuple<int, int>> curre
         float yPosition = stof(currentAircraft[2]); // y-axis position of the aircraft.
 
         // Calculate the aircraft's current position in the airspace grid.
-        tuple<int, int> airspaceGridPosition;
-
-        // Calculate the position of the aircraft on the visual grid along the x-axis.
-        int posX = round(xPosition / 1000);
-
-        // Calculate the position of the aircraft on the visual grid along the y-axis.
-        int posY = round(yPosition / 2000);
+        currentPositions.push_back(airspaceGridPosition(xPosition, yPosition));
+    }
 
-        airspaceGridPosition = make_tuple(posX, posY);
+    return currentPositions;
+}
 
-        currentPositions.push_back(airspaceGridPosition);
+vector<tuple<int, int>> calculateAirspacePositions(vector<tuple<int, int>> currentPositions, const vector<TrackRecord> &newAircrafts)
+{
+    for (const TrackRecord &currentAircraft : newAircrafts)
+    {
+        // The track records hold the positions directly, so nothing needs to be parsed.
+        currentPositions.push_back(airspaceGridPosition(currentAircraft.positionX, currentAircraft.positionY));
     }
 
     return currentPositions;
 }
 
-void drawAirspace(vector<array<string, 5>> regularAircrafts, vector<array<string, 8>> augmentedAircrafts, vector<tuple<int, int>> gridPositions)
+tuple<int, int> airspaceGridPosition(float xPosition, float yPosition)
 {
-    // Combine the regular and augmented aircraft data.
-    vector<string> aircrafts;
+    // Calculate the position of the aircraft on the visual grid along the x-axis.
+    int posX = round(xPosition / 1000);
+
+    // Calculate the position of the aircraft on the visual grid along the y-axis.
+    int posY = round(yPosition / 2000);
+
+    return make_tuple(posX, posY);
+}
+
+void drawAirspace(const vector<TrackRecord> &regularAircrafts, vector<array<string, 8>> augmentedAircrafts, vector<tuple<int, int>> gridPositions)
+{
+    // Violation status of the regular aircrafts, followed by the augmented aircrafts.
+    vector<bool> aircraftsInViolation;
 
-    // Add each line of data regular aircraft data to the vector.
     for (size_t i = 0; i < regularAircrafts.size(); i++)
     {
-        // Combine the aircraft data into a single string.
-        string currentAircraft = regularAircrafts[i][0] + " " + regularAircrafts[i][1] + " " + regularAircrafts[i][2] + " " + regularAircrafts[i][3] + " " + regularAircrafts[i][4];
-
-        // Add the string of data to the vector.
-        aircrafts.push_back(currentAircraft);
+        aircraftsInViolation.push_back(regularAircrafts[i].isViolation == 1);
     }
 
-    // Add each line of augmented aircraft data to the vector.
-    if (augmentedAircrafts.size() > 0)
+    // The violation status is the last part of the augmented aircraft data.
+    for (size_t i = 0; i < augmentedAircrafts.size(); i++)
     {
-        for (size_t i = 0; i < augmentedAircrafts.size(); i++)
-        {
-            // Combine the aircraft data into a single string.
-            string currentAircraft = augmentedAircrafts[i][0] + " " + augmentedAircrafts[i][1] + " " + augmentedAircrafts[i][2] + " " + augmentedAircrafts[i][3] + " " + augmentedAircrafts[i][4] + " " + augmentedAircrafts[i][5] + " " + augmentedAircrafts[i][6] + " " + augmentedAircrafts[i][7];
-
-            // Add the string of data to the vector.
-            aircrafts.push_back(currentAircraft);
-        }
+        const string &violation = augmentedAircrafts[i][7];
+        aircraftsInViolation.push_back(!violation.empty() && violation.back() == '1');
     }
 
     // Draw the airspace grid.
@@ -323,14 +360,14 @@ void drawAirspace(vector<array<string, 5>> regularAircrafts, vector<array<string
         for (int j = 0; j < columns; j++)
         {
             bool aircraftPresent = false;
-            string currentAircraft;
+            bool currentAircraftInViolation = false;
             // Iterate through the vector to check if the aircraft is present.
             for (size_t k = 0; k < gridPositions.size(); k++)
             {
                 if (gridPositions[k] == make_tuple(i, j))
                 {
-                    aircraftPresent = true;         // An aircraft is present.
-                    currentAircraft = aircrafts[k]; // Store the current aircraft data temporarily.
+                    aircraftPresent = true;                               // An aircraft is present.
+                    currentAircraftInViolation = aircraftsInViolation[k]; // Store the current aircraft status temporarily.
                     break;
                 }
             }
@@ -338,7 +375,7 @@ void drawAirspace(vector<array<string, 5>> regularAircrafts, vector<array<string
             // Check if one of the grid positions matches the current position.  Otherwise, leave it blank.
             if (aircraftPresent)
             {
-                if (currentAircraft.back() == '1')
+                if (currentAircraftInViolation)
                 {
                     cout << "X"; // Aircraft in violation.
                 }
@@ -366,247 +403,444 @@ void drawAirspace(vector<array<string, 5>> regularAircrafts, vector<array<string
 void *aircraftDataHandling(void *arg)
 {
     ThreadParameters *args = static_cast<ThreadParameters *>(arg);
+    TaskMetrics &metrics = taskMetrics.add("aircraft data"); // Printed on SIGUSR1
+    uint64_t previousStart = 0;                              // Monotonic start of the previous run, 0 before the first one
 
     while (!*(args->terminateNow))
     {
-        // Store the starting time of this task
-        steady_clock::time_point startTime = steady_clock::now();
+        // Store the starting time of this task, on the simulation clock, for its deadline
+        double startTime = simClock->now();
+
+        // How late this run started in real time, compared to one period of the clock after the previous one.
+        uint64_t runStart = monotonicNanoseconds();
+        double lateness = (previousStart == 0) ? 0.0 : (runStart - previousStart) * 1e-9 - DISPLAY_PERIOD / simClock->getMultiplier();
+        previousStart = runStart;
+
+        double sleepTime;
+        { // The execution time is recorded in real time when the timer goes out of scope.
+            ScopedTaskTimer timer(metrics, uint64_t(max(lateness, 0.0) * 1e9));
+
+            // Clear all of the vectors
+            regularAircraftData = {};
+            augmentedAircraftData = {};
+            aircraftGridPositions = {};
+
+            unique_lock<mutex> dataLock(dataMutex);
+            reopenTracks(args);
+            lockData(args->sem_data); // The data thread locks the semaphore for all data.
+            // Apply the changes to the regular aircraft data published since the last update.
+            uint64_t appliedBefore = appliedDeltas, resyncsBefore = keyframeResyncs;
+            updateTrackCopy(args->shm_ptr_reg);
+            systemMetrics.add(DISPLAY_TRACK_UPDATES, appliedDeltas - appliedBefore);
+            systemMetrics.add(DISPLAY_RESYNCS, keyframeResyncs - resyncsBefore);
+            systemMetrics.add(DISPLAY_REFRESHES);
+            for (const auto &track : trackCopy)
+            {
+                regularAircraftData.push_back(track.second);
+            }
 
-        // Clear all of the vectors
-        regularAircraftData = {};
-        augmentedAircraftData = {};
-        aircraftGridPositions = {};
+            // Calculate the position of each regular aircraft that will be displayed on the grid.
+            aircraftGridPositions = calculateAirspacePositions(aircraftGridPositions, regularAircraftData);
 
-        sem_wait(args->sem_data); // The data thread locks the semaphore for all data.
-        // Read the shared memory that holds the regular aircraft data.
-        char *regularData = static_cast<char *>(args->shm_ptr_reg);
+            // Read the shared memory that holds the augmented aircraft data.
+            char *augmentedData = static_cast<char *>(args->shm_ptr_aug);
 
-        // Turn the regularData character buffer into a string, to ensure that it is null-terminated.
-        string regularDataString(regularData);
+            // Turn the augmentedData character buffer into a string, to ensure that it is null-terminated.
+            string augmentedDataString(augmentedData);
 
-        // Create a stringstream object from the shared memory string, so that it can be parsed into individual lines.
-        stringstream regularDataStringStream(regularDataString);
+            // Create a stringstream object from the shared memory string, so that it can be parsed into individual lines.
+            stringstream augmentedDataStringStream(augmentedDataString);
 
-        // Create a string representing a single line of the regular aircraft data.
-        string regularDataLine;
+            // Create a string representing a single line of the augmented aircraft data.
+            string augmentedDataLine;
 
-        // Read each line from the stringstream individually.
-        while (getline(regularDataStringStream, regularDataLine))
-        {
-            // Create a temporary array of 5 strings that represents a de-constructed line of data.
-            array<string, 5> regularDataLineDeconstructed;
+            // Read each line from the stringstream individually.
+            while (getline(augmentedDataStringStream, augmentedDataLine))
+            {
+                // Create a temporary array of 5 strings that represents a de-constructed line of data.
+                array<string, 8> augmentedDataLineDeconstructed;
 
-            // Create a stringstream object from the current line of data that is being read.
-            stringstream regularDataLineStringStream(regularDataLine);
+                // Create a stringstream object from the current line of data that is being read.
+                stringstream augmentedDataLineStringStream(augmentedDataLine);
 
-            // Create a string representing a single aircraft variable.
-            string regularDataVariable;
+                // Create a string representing a single aircraft variable.
+                string augmentedDataVariable;
 
-            // Add each variable to the string array.
-            for (size_t i = 0; i < regularDataLineDeconstructed.size(); i++)
-            {
-                if (getline(regularDataLineStringStream, regularDataVariable, ' '))
+                // Add each variable to the string array.
+                for (size_t i = 0; i < augmentedDataLineDeconstructed.size(); i++)
                 {
-                    regularDataLineDeconstructed[i] = regularDataVariable;
-                }
-                else
-                {
-                    cerr << "Reading the data has failed: " << regularDataVariable << endl;
-                    break;
+                    if (getline(augmentedDataLineStringStream, augmentedDataVariable, ' '))
+                    {
+                        augmentedDataLineDeconstructed[i] = augmentedDataVariable;
+                    }
+                    else
+                    {
+                        cerr << "Reading the data has failed: " << augmentedDataVariable << endl;
+                        break;
+                    }
                 }
+
+                // Append the line of regular aircraft data to its associated vector
+                augmentedAircraftData.push_back(augmentedDataLineDeconstructed);
             }
 
-            // Append the line of regular aircraft data to its associated vector
-            regularAircraftData.push_back(regularDataLineDeconstructed);
-        }
+            // Calculate the position of each augmented aircraft that will be displayed on the grid, granted any exist.
+            if (augmentedAircraftData.size() > 0)
+            {
+                augmentedAircraftsPresent = true; // Augmented aircraft data is present in the system.
 
-        // Calculate the position of each regular aircraft that will be displayed on the grid.
-        aircraftGridPositions = calculateAirspacePositions(aircraftGridPositions, regularAircraftData);
+                aircraftGridPositions = calculateAirspacePositions(aircraftGridPositions, augmentedAircraftData);
+            }
+            sem_post(args->sem_data); // The data thread unlocks the semaphore for all data.
+            dataLock.unlock();
 
-        // Read the shared memory that holds the augmented aircraft data.
-        char *augmentedData = static_cast<char *>(args->shm_ptr_aug);
+            // Beginning of the visual display
+            insertBanner("Monitored En-Route Airspace" + getCurrentTimestamp());
 
-        // Turn the augmentedData character buffer into a string, to ensure that it is null-terminated.
-        string augmentedDataString(augmentedData);
+            // Print the current state of the airspace.
+            drawAirspace(regularAircraftData, augmentedAircraftData, aircraftGridPositions);
 
-        // Create a stringstream object from the shared memory string, so that it can be parsed into individual lines.
-        stringstream augmentedDataStringStream(augmentedDataString);
+            // Print all regular aircraft data, line-by-line.
+            insertBanner("Generic Aircraft Information");
+            for (size_t i = 0; i < regularAircraftData.size(); i++)
+            {
+                // Print all part of the data in a line.
+                cout << formatTrack(regularAircraftData[i]) << endl;
+            }
+            cout << appliedDeltas << " track updates applied, " << keyframeResyncs << " copies from a keyframe" << endl;
 
-        // Create a string representing a single line of the augmented aircraft data.
-        string augmentedDataLine;
+            // Print all augmented aircraft data, line-by-line.
+            if (augmentedAircraftsPresent)
+            { // Augmented aircraft data is present.
+                insertBanner("Augmented Aircraft Information");
+                for (size_t i = 0; i < augmentedAircraftData.size(); i++)
+                {
+                    // Create temporary object for each line of data.
+                    array<string, 8> currentAircraftData = augmentedAircraftData[i];
 
-        // Read each line from the stringstream individually.
-        while (getline(augmentedDataStringStream, augmentedDataLine))
-        {
-            // Create a temporary array of 5 strings that represents a de-constructed line of data.
-            array<string, 8> augmentedDataLineDeconstructed;
+                    // Print all part of the data in a line.
+                    for (size_t j = 0; j < currentAircraftData.size(); j++)
+                    {
+                        cout << currentAircraftData[j] << " ";
+                    }
+
+                    cout << endl;
+                }
+            }
+            // End of the visual display.
 
-            // Create a stringstream object from the current line of data that is being read.
-            stringstream augmentedDataLineStringStream(augmentedDataLine);
+            // Store the ending time of this task
+            double endTime = simClock->now();
 
-            // Create a string representing a single aircraft variable.
-            string augmentedDataVariable;
+            // Calculate the execution time of this task, on the simulation clock
+            double executionTime = endTime - startTime;
 
-            // Add each variable to the string array.
-            for (size_t i = 0; i < augmentedDataLineDeconstructed.size(); i++)
+            // Calculate the maximum allowable time for the task to sleep without missing its deadline
+            sleepTime = DISPLAY_PERIOD - executionTime;
+            if (sleepTime < 0.0)
             {
-                if (getline(augmentedDataLineStringStream, augmentedDataVariable, ' '))
-                {
-                    augmentedDataLineDeconstructed[i] = augmentedDataVariable;
-                }
-                else
-                {
-                    cerr << "Reading the data has failed: " << augmentedDataVariable << endl;
-                    break;
-                }
+                timer.missedDeadline();
             }
+        }
 
-            // Append the line of regular aircraft data to its associated vector
-            augmentedAircraftData.push_back(augmentedDataLineDeconstructed);
+        // Make the thread sleep for its maximum allowable sleeping time.
+        if (sleepTime >= 0.0)
+        { // The thread can sleep for the remaining amount of its period.
+            simClock->sleepFor(sleepTime);
+        }
+        else
+        { // The thread's execution time has exceeded its period.
+            cerr << "Caution: The data handling thread has missed its deadline..." << endl;
         }
+    }
 
-        // Calculate the position of each augmented aircraft that will be displayed on the grid, granted any exist.
-        if (augmentedAircraftData.size() > 0)
-        {
-            augmentedAircraftsPresent = true; // Augmented aircraft data is present in the system.
+    return nullptr;
+}
 
-            aircraftGridPositions = calculateAirspacePositions(aircraftGridPositions, augmentedAircraftData);
-        }
-        sem_post(args->sem_data); // The data thread unlocks the semaphore for all data.
+void *violationHandling(void *arg)
+{
+    ThreadParameters *args = static_cast<ThreadParameters *>(arg);
+    TaskMetrics &metrics = taskMetrics.add("violations"); // Printed on SIGUSR1
+    uint64_t previousStart = 0;                           // Monotonic start of the previous run, 0 before the first one
 
-        // Beginning of the visual display
-        insertBanner("Monitored En-Route Airspace" + getCurrentTimestamp());
+    while (!*(args->terminateNow))
+    {
+        // Store the starting time of this task, on the simulation clock, for its deadline
+        double startTime = simClock->now();
 
-        // Print the current state of the airspace.
-        drawAirspace(regularAircraftData, augmentedAircraftData, aircraftGridPositions);
+        // How late this run started in real time, compared to one period of the clock after the previous one.
+        uint64_t runStart = monotonicNanoseconds();
+        double lateness = (previousStart == 0) ? 0.0 : (runStart - previousStart) * 1e-9 - DISPLAY_PERIOD / simClock->getMultiplier();
+        previousStart = runStart;
 
-        // Print all regular aircraft data, line-by-line.
-        insertBanner("Generic Aircraft Information");
-        for (size_t i = 0; i < regularAircraftData.size(); i++)
-        {
-            // Create temporary object for each line of data.
-            array<string, 5> currentAircraftData = regularAircraftData[i];
+        double sleepTime;
+        { // The execution time is recorded in real time when the timer goes out of scope.
+            ScopedTaskTimer timer(metrics, uint64_t(max(lateness, 0.0) * 1e9));
+
+            // Clear the vectors holding the outdated violation data.
+            violations = {};
 
-            // Print all part of the data in a line.
-            for (size_t j = 0; j < currentAircraftData.size(); j++)
+            unique_lock<mutex> dataLock(dataMutex);
+            lockData(args->sem_data); // The violations thread locks the semaphore for all data.
+            // Read the ring of alerts written by the Computer.
+            const AlertsHeader *alertsHeader = static_cast<const AlertsHeader *>(args->shm_ptr_viol);
+            const Alert *alertData = alertRecords(args->shm_ptr_viol);
+
+            if (alertsHeader->magic == ALERTS_MAGIC && alertsHeader->version == ALERTS_VERSION)
             {
-                cout << currentAircraftData[j] << " ";
-            }
+                uint64_t newestSequence = alertsHeader->sequence;
 
-            cout << endl;
-        }
+                // The sequence went back when the Computer restarted with a new ring, its alerts are read from the start.
+                if (newestSequence < lastAlertSequence)
+                {
+                    lastAlertSequence = newestSequence - min(newestSequence, uint64_t(ALERT_CAPACITY));
+                }
 
-        // Print all augmented aircraft data, line-by-line.
-        if (augmentedAircraftsPresent)
-        { // Augmented aircraft data is present.
-            insertBanner("Augmented Aircraft Information");
-            for (size_t i = 0; i < augmentedAircraftData.size(); i++)
+                // The oldest alerts are overwritten once the ring is full.
+                if (newestSequence - lastAlertSequence > ALERT_CAPACITY)
+                {
+                    violations.push_back("Caution: " + to_string(newestSequence - lastAlertSequence - ALERT_CAPACITY) + " alerts were overwritten before they could be displayed...");
+                    lastAlertSequence = newestSequence - ALERT_CAPACITY;
+                }
+
+                // Format only the alerts that have not been printed yet.
+                for (uint64_t sequence = lastAlertSequence + 1; sequence <= newestSequence; sequence++)
+                {
+                    violations.push_back(formatAlert(alertData[sequence % ALERT_CAPACITY]));
+                }
+                lastAlertSequence = newestSequence;
+            }
+            sem_post(args->sem_data); // The violations thread unlocks the semaphore for all data.
+            dataLock.unlock();
+
+            // Check if any violations are present in the airspace.
+            if (violations.size() > 0)
             {
-                // Create temporary object for each line of data.
-                array<string, 8> currentAircraftData = augmentedAircraftData[i];
+                insertBanner("Violations" + getCurrentTimestamp());
 
-                // Print all part of the data in a line.
-                for (size_t j = 0; j < currentAircraftData.size(); j++)
+                // Print all of the violations present in the airspace, lin-by-line
+                for (size_t i = 0; i < violations.size(); i++)
                 {
-                    cout << currentAircraftData[j] << " ";
+                    cout << violations[i] << endl;
                 }
 
-                cout << endl;
+                // Emit a sonorous alarm
+                cout << '\a';
             }
-        }
-        // End of the visual display.
 
-        // Store the ending time of this task
-        steady_clock::time_point endTime = steady_clock::now();
+            // Store the ending time of this task
+            double endTime = simClock->now();
 
-        // Calculate the execution time of this task
-        duration<double> executionTime = duration_cast<duration<double>>(endTime - startTime);
+            // Calculate the execution time of this task, on the simulation clock
+            double executionTime = endTime - startTime;
 
-        // Calculate the maximum allowable time for the task to sleep without missing its deadline
-        double sleepTime = 5.0 - executionTime.count();
+            // Calculate the maximum allowable time for the task to sleep without missing its deadline
+            sleepTime = DISPLAY_PERIOD - executionTime;
+            if (sleepTime < 0.0)
+            {
+                timer.missedDeadline();
+            }
+        }
 
         // Make the thread sleep for its maximum allowable sleeping time.
         if (sleepTime >= 0.0)
         { // The thread can sleep for the remaining amount of its period.
-            this_thread::sleep_for(chrono::duration<double>(sleepTime));
+            simClock->sleepFor(sleepTime);
         }
         else
         { // The thread's execution time has exceeded its period.
-            cerr << "Caution: The data handling thread has missed its deadline..." << endl;
+            cerr << "Caution: The violation handling thread has missed its deadline..." << endl;
         }
     }
 
     return nullptr;
 }
 
-void *violationHandling(void *arg)
+// Turns an alert record written by the Computer into the line printed in the visual display.
+string formatAlert(const Alert &alert)
 {
-    ThreadParameters *args = static_cast<ThreadParameters *>(arg);
+    // Time at which the conflict was first detected.
+    time_t firstSeen = static_cast<time_t>(alert.firstSeen);
+    stringstream since;
+    since << put_time(localtime(&firstSeen), "%H:%M:%S");
 
-    while (!*(args->terminateNow))
+    stringstream line;
+    if (alert.kind == ALERT_SEPARATION_VIOLATION)
+    {
+        line << "ALERT: Separation violation between " << alert.firstID << " and " << alert.secondID
+             << " (since " << since.str() << ")";
+    }
+    else
     {
-        // Store the starting time of this task
-        steady_clock::time_point startTime = steady_clock::now();
+        line << "ALERT: Collision will occur in " << fixed << setprecision(1) << alert.timeToConflict
+             << " seconds between " << alert.firstID << " and " << alert.secondID
+             << " (first predicted at " << since.str() << ")";
+    }
 
-        // Clear the vectors holding the outdated violation data.
-        violations = {};
+    return line.str();
+}
 
-        sem_wait(args->sem_data); // The violations thread locks the semaphore for all data.
-        // Read the shared memory that holds the violation data
-        char *violationData = static_cast<char *>(args->shm_ptr_viol);
+string formatTrack(const TrackRecord &track)
+{
+    // Same columns as the aircraft data: ID, position and violation status.
+    stringstream line;
+    line << track.aircraftID << " " << fixed << setprecision(6) << track.positionX << " " << track.positionY << " "
+         << track.positionZ << " " << int(track.isViolation);
 
-        // Turn the violationData character buffer into a string, to ensure that it is null-terminated.
-        string violationDataString(violationData);
+    return line.str();
+}
 
-        // Create a stringstream object from the shared memory string, so that it can be parsed into individual lines.
-        stringstream violationDataStringStream(violationDataString);
+void applyTrackDelta(const TrackDelta &delta)
+{
+    if (delta.kind == TRACK_UPDATED)
+    {
+        trackCopy[delta.track.aircraftID] = delta.track;
+    }
+    else if (delta.kind == TRACK_REMOVED)
+    {
+        trackCopy.erase(delta.track.aircraftID);
+    }
+    appliedDeltas++;
+}
 
-        // Create a string representing a single line of the violation data.
-        string violationDataLine;
+// Brings the copy of the tracks up to date. Must be called with the data semaphore held.
+void updateTrackCopy(void *segment)
+{
+    TracksHeader *header = static_cast<TracksHeader *>(segment);
+    TrackDelta *deltas = trackDeltas(segment);
+    uint32_t deltaCapacity = header->deltaCapacity;
+    uint64_t latest = header->deltaSequence;
+    if (deltaCapacity == 0)
+    {
+        return; // Not written by the Computer yet.
+    }
 
-        // Read each line from the stringstream individually.
-        while (getline(violationDataStringStream, violationDataLine))
+    // The deltas after the cursor are still in the ring unless the Computer skipped the sequence or went
+    // around the ring, or was restarted.
+    bool resync = !tracksSynced || latest < deltaCursor || latest - deltaCursor > deltaCapacity;
+    for (uint64_t sequence = deltaCursor + 1; !resync && sequence <= latest; sequence++)
+    {
+        const TrackDelta &delta = deltas[sequence % deltaCapacity];
+        if (delta.sequence != sequence)
         {
-            violations.push_back(violationDataLine);
+            resync = true; // Overwritten, the copy is made again from the keyframe below.
+            break;
         }
-        sem_post(args->sem_data); // The violations thread unlocks the semaphore for all data.
+        applyTrackDelta(delta);
+        deltaCursor = sequence;
+    }
+    if (!resync)
+    {
+        return;
+    }
 
-        // Check if any violations are present in the airspace.
-        if (violations.size() > 0)
+    // Copy the keyframe, then apply the deltas written after it.
+    trackCopy.clear();
+    TrackRecord *records = trackRecords(segment);
+    uint32_t count = min(header->count, header->capacity);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        trackCopy[records[i].aircraftID] = records[i];
+    }
+    deltaCursor = header->keyframeSequence;
+    for (uint64_t sequence = deltaCursor + 1; sequence <= latest; sequence++)
+    {
+        const TrackDelta &delta = deltas[sequence % deltaCapacity];
+        if (delta.sequence == sequence)
         {
-            insertBanner("Violations" + getCurrentTimestamp());
+            applyTrackDelta(delta);
+        }
+        deltaCursor = sequence;
+    }
+    tracksSynced = true;
+    keyframeResyncs++;
+}
 
-            // Print all of the violations present in the airspace, lin-by-line
-            for (size_t i = 0; i < violations.size(); i++)
-            {
-                cout << violations[i] << endl;
-            }
+// Locks the semaphore for all data, the time spent waiting for it is published in the metrics.
+void lockData(sem_t *semaphore)
+{
+    uint64_t start = monotonicNanoseconds();
+    sem_wait(semaphore);
+    systemMetrics.add(DISPLAY_SEMAPHORE_WAIT, monotonicNanoseconds() - start);
+}
 
-            // Emit a sonorous alarm
-            cout << '\a';
-        }
+// Maps the tracks, reading the header first since the Computer sizes the shared memory from its configured
+// capacity. Returns nullptr, with the reason in error, if the Computer has not written the header yet.
+void *mapTracks(int fd, size_t &size, const char *&error)
+{
+    struct stat status;
+    if (fstat(fd, &status) == -1 || size_t(status.st_size) < sizeof(TracksHeader))
+    {
+        error = "The shared memory for the regular aircrafts is not ready...";
+        return nullptr;
+    }
 
-        // Store the ending time of this task
-        steady_clock::time_point endTime = steady_clock::now();
+    void *segment = mmap(0, sizeof(TracksHeader), PROT_READ, MAP_SHARED, fd, 0);
+    if (segment == MAP_FAILED)
+    {
+        error = "Shared Memory Mapping for the regular aircrafts failed...";
+        return nullptr;
+    }
+    TracksHeader header = *static_cast<TracksHeader *>(segment);
+    munmap(segment, sizeof(TracksHeader));
+    if (header.magic != TRACKS_MAGIC || header.version != TRACKS_VERSION || size_t(status.st_size) < tracksSegmentSize(header.capacity))
+    {
+        error = "The shared memory for the regular aircrafts has an unknown layout...";
+        return nullptr;
+    }
 
-        // Calculate the execution time of this task
-        duration<double> executionTime = duration_cast<duration<double>>(endTime - startTime);
+    segment = mmap(0, tracksSegmentSize(header.capacity), PROT_READ, MAP_SHARED, fd, 0);
+    if (segment == MAP_FAILED)
+    {
+        error = "Shared Memory Mapping for the regular aircrafts failed...";
+        return nullptr;
+    }
+    size = tracksSegmentSize(header.capacity);
+    return segment;
+}
 
-        // Calculate the maximum allowable time for the task to sleep without missing its deadline
-        double sleepTime = 5.0 - executionTime.count();
+// A Computer that restarts after a clean shutdown creates the tracks and the data semaphore again under
+// the same names, and the old ones are never written again. Opens the new ones when that happened. Must
+// be called with dataMutex held and without the data semaphore.
+void reopenTracks(ThreadParameters *args)
+{
+    // sem_open returns the semaphore already open unless it was unlinked and created again.
+    sem_t *semaphore = sem_open(SEMAPHORE_DATA, 0);
+    if (semaphore != SEM_FAILED)
+    {
+        sem_close(semaphore == args->sem_data ? semaphore : args->sem_data);
+        args->sem_data = semaphore;
+    }
 
-        // Make the thread sleep for its maximum allowable sleeping time.
-        if (sleepTime >= 0.0)
-        { // The thread can sleep for the remaining amount of its period.
-            this_thread::sleep_for(chrono::duration<double>(sleepTime));
-        }
-        else
-        { // The thread's execution time has exceeded its period.
-            cerr << "Caution: The violation handling thread has missed its deadline..." << endl;
-        }
+    int fd = shm_open(SHARED_MEMORY_AIRCRAFT_DATA, O_RDONLY, 0666);
+    if (fd == -1)
+    {
+        return; // The Computer is not running, the tracks already read are kept.
+    }
+    struct stat current, opened;
+    if (fstat(fd, &current) == -1 || fstat(args->shm_fd_reg, &opened) == -1 ||
+        (current.st_dev == opened.st_dev && current.st_ino == opened.st_ino))
+    {
+        close(fd);
+        return;
     }
 
-    return nullptr;
+    size_t size;
+    const char *error;
+    void *segment = mapTracks(fd, size, error);
+    if (segment == nullptr)
+    {
+        close(fd); // Still being set up by the Computer, tried again on the next update.
+        return;
+    }
+    munmap(args->shm_ptr_reg, regularDataSize);
+    close(args->shm_fd_reg);
+    args->shm_fd_reg = fd;
+    args->shm_ptr_reg = segment;
+    regularDataSize = size;
+    tracksSynced = false; // The copy is made again from the keyframe of the new Computer.
+    deltaCursor = 0;
+    cout << "The Computer was restarted, the tracks are read again from the start..." << endl;
 }
 
 void *terminationHandling(void *arg)
@@ -660,10 +894,11 @@ void *terminationHandling(void *arg)
     // Check if the subsystem should be terminating.
     if (*(args->terminateNow))
     {
+        unique_lock<mutex> dataLock(dataMutex);
         sem_wait(args->sem_data); // The shared memory should block other processes while being cleaned up.
         // Clean up the shared memory for the data.
         // Unmaps the shared memory for the regular aircrafts.
-        if (munmap(args->shm_ptr_reg, SHM_SIZE) == -1)
+        if (munmap(args->shm_ptr_reg, regularDataSize) == -1)
         {
             perror("munmap() for the regular aircrafts failed"); // This will print the String argument with the errno value appended.
         }
@@ -687,7 +922,7 @@ void *terminationHandling(void *arg)
         }
 
         // Unmaps the shared memory for the violations.
-        if (munmap(args->shm_ptr_viol, SHM_SIZE) == -1)
+        if (munmap(args->shm_ptr_viol, ALERTS_SHM_SIZE) == -1)
         {
             perror("munmap() for the violations failed"); // This will print the String argument with the errno value appended.
         }
@@ -698,6 +933,7 @@ void *terminationHandling(void *arg)
             perror("close() for the violations failed"); // This will print the String argument with the errno value appended.
         }
         sem_post(args->sem_data);
+        dataLock.unlock();
 
         // Clean up the shared memory for the termination signal.
         // Unmaps the shared memory for the termination.
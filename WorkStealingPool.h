@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+using namespace std;
+
+/*NOTE: The work-stealing pool runs a batch of independent tiles on a fixed set of worker threads.
+    The tiles are dealt out round-robin, every worker takes tiles from the front of its own queue,
+    and a worker whose queue is empty steals from the back of the other queues, so uneven tiles
+    do not leave cores idle. */
+
+class WorkStealingPool
+{
+public:
+    // Constructor
+    WorkStealingPool(size_t workers)
+    {
+        stopping = false;
+        jobGeneration = 0;
+        remaining = 0;
+        steals = 0;
+
+        for (size_t i = 0; i < workers; i++)
+        {
+            queues.push_back(make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < workers; i++)
+        {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    // Destructor
+    ~WorkStealingPool()
+    {
+        {
+            lock_guard<mutex> lock(jobMutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+
+        for (auto &worker : threads)
+        {
+            worker.join();
+        }
+    }
+
+    size_t getWorkerCount() const
+    {
+        return threads.size();
+    }
+
+    // Number of tiles taken from another worker's queue since the pool was created.
+    size_t getSteals() const
+    {
+        return steals;
+    }
+
+    // Runs task(tile, worker) for every tile in [0, tileCount) and returns once all of them are done.
+    void run(size_t tileCount, const function<void(size_t, size_t)> &task)
+    {
+        if (tileCount == 0)
+        {
+            return;
+        }
+
+        // Without workers the tiles are run by the calling thread.
+        if (threads.empty())
+        {
+            for (size_t tile = 0; tile < tileCount; tile++)
+            {
+                task(tile, 0);
+            }
+            return;
+        }
+
+        unique_lock<mutex> lock(jobMutex);
+        remaining = tileCount;
+
+        // Every tile carries its task, since a worker finishing the previous batch may already pick it up.
+        for (size_t tile = 0; tile < tileCount; tile++)
+        {
+            WorkerQueue &queue = *queues[tile % queues.size()];
+            lock_guard<mutex> queueLock(queue.lock);
+            queue.tiles.push_back({&task, tile});
+        }
+
+        jobGeneration++;
+        jobReady.notify_all();
+
+        jobDone.wait(lock, [this]
+                     { return remaining == 0; });
+    }
+
+private:
+    struct Tile
+    {
+        const function<void(size_t, size_t)> *task;
+        size_t index;
+    };
+
+    struct WorkerQueue
+    {
+        mutex lock;
+        deque<Tile> tiles;
+    };
+
+    void workerLoop(size_t worker)
+    {
+        size_t seenGeneration = 0;
+
+        while (true)
+        {
+            {
+                unique_lock<mutex> lock(jobMutex);
+                jobReady.wait(lock, [&]
+                              { return stopping || jobGeneration != seenGeneration; });
+                if (stopping)
+                {
+                    return;
+                }
+                seenGeneration = jobGeneration;
+            }
+
+            Tile tile;
+            while (takeTile(worker, tile))
+            {
+                (*tile.task)(tile.index, worker);
+
+                if (remaining.fetch_sub(1) == 1)
+                {
+                    // The last tile of the batch wakes up the caller of run().
+                    lock_guard<mutex> lock(jobMutex);
+                    jobDone.notify_all();
+                }
+            }
+        }
+    }
+
+    // Takes the next tile from this worker's queue, or steals one from another worker.
+    bool takeTile(size_t worker, Tile &tile)
+    {
+        {
+            WorkerQueue &own = *queues[worker];
+            lock_guard<mutex> lock(own.lock);
+            if (!own.tiles.empty())
+            {
+                tile = own.tiles.front();
+                own.tiles.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < queues.size(); offset++)
+        {
+            WorkerQueue &victim = *queues[(worker + offset) % queues.size()];
+            lock_guard<mutex> lock(victim.lock);
+            if (!victim.tiles.empty())
+            {
+                tile = victim.tiles.back();
+                victim.tiles.pop_back();
+                steals++;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    vector<unique_ptr<WorkerQueue>> queues; // One queue of tiles per worker.
+    vector<thread> threads;
+    mutex jobMutex;
+    condition_variable jobReady; // Signals the workers that a new batch is available.
+    condition_variable jobDone;  // Signals the caller that the batch is complete.
+    size_t jobGeneration;        // Incremented for every batch.
+    atomic<size_t> remaining;    // Tiles of the current batch that are not done yet.
+    atomic<size_t> steals;
+    bool stopping;
+};